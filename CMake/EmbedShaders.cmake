@@ -0,0 +1,40 @@
+# Generates a source with spirv of all of the compiled shaders, defines EmbeddedShaders::GetEntries
+# Usage: cmake -DSPIRV_DIR=<dir> -DOUTPUT_FILE=<file> -P EmbedShaders.cmake
+
+file(GLOB_RECURSE SPIRV_FILES RELATIVE "${SPIRV_DIR}" "${SPIRV_DIR}/*.spv")
+list(SORT SPIRV_FILES) # EmbeddedShaders::Find relies on entries being sorted by name
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(INDEX 0)
+
+foreach(SPIRV_FILE IN LISTS SPIRV_FILES)
+    file(READ "${SPIRV_DIR}/${SPIRV_FILE}" CONTENT HEX)
+
+    # Spirv is written as little-endian words, 8 words per line
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " WORDS "${CONTENT}")
+    set(WORD "0x........, ")
+    string(REGEX REPLACE "(${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD})" "\\1\n        " WORDS "${WORDS}")
+    string(REGEX REPLACE "\\.spv$" "" SHADER_NAME "${SPIRV_FILE}")
+
+    string(APPEND ARRAYS "    // ${SHADER_NAME}\n    constexpr uint32_t shader${INDEX}[] = {\n        ${WORDS}};\n\n")
+    string(APPEND ENTRIES "        { \"${SHADER_NAME}\", shader${INDEX} },\n")
+
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+file(WRITE "${OUTPUT_FILE}"
+"// Generated by CMake/EmbedShaders.cmake, do not edit
+#include \"Engine/Render/Vulkan/Shaders/EmbeddedShaders.hpp\"
+
+namespace EmbeddedShadersData
+{
+${ARRAYS}    constexpr EmbeddedShaders::Entry entries[] = {
+${ENTRIES}    };
+}
+
+std::span<const EmbeddedShaders::Entry> EmbeddedShaders::GetEntries()
+{
+    return EmbeddedShadersData::entries;
+}
+")
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Engine/Window.hpp"
 #include "Engine/Scene/Scene.hpp"
+#include "Engine/Render/LodStreamer.hpp"
 #include "Engine/InputUtils.hpp"
 
 namespace ES // Event system
@@ -21,7 +22,10 @@ namespace ES // Event system
     struct BeforeSwapchainRecreated {};
     struct SwapchainRecreated {};
 
-    struct TryReloadShaders {};
+    struct TryReloadShaders
+    {
+        std::vector<std::string> changedFiles; // Relative to the shaders dir, empty means reload everything
+    };
 
     struct SceneOpened
     {
@@ -30,6 +34,15 @@ namespace ES // Event system
 
     struct SceneClosed {};
 
+    // Defragmentation moved relocatable buffers, their handles and device addresses are different now
+    struct BuffersRelocated {};
+
+    // Fired every frame while lods are streamed, stats are empty once the scene is closed
+    struct LodStreamingUpdated
+    {
+        LodStreamer::Stats stats{};
+    };
+
     struct KeyInput
     {
         Key key{};
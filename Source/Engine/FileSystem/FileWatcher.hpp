@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Engine/FileSystem/FilePath.hpp"
+
+// Reports files written inside of the directory tree, subdirectories created later are watched as well.
+// Implemented with inotify, on other platforms changes are never reported
+class FileWatcher
+{
+public:
+    struct Changes
+    {
+        std::vector<std::string> files;
+        bool overflow = false; // Events were dropped, any file might have changed
+    };
+
+    FileWatcher(const FilePath& directory, std::vector<FilePath> excludedDirectories = {});
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    FileWatcher(FileWatcher&&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+
+    // Never blocks, returns unique paths relative to the watched directory changed since the previous call
+    Changes PollChanges();
+
+    bool IsActive() const
+    {
+        return fileDescriptor != -1;
+    }
+
+private:
+    void AddWatches(const std::filesystem::path& directory);
+
+    std::filesystem::path rootDirectory;
+    std::vector<std::filesystem::path> excludedDirectories;
+
+    int fileDescriptor = -1;
+    std::unordered_map<int, std::filesystem::path> watchedDirectories; // Relative to the root
+};
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "Engine/FileSystem/FileWatcher.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace FileWatcherDetails
+{
+    // Editors either write files in place or replace them with a renamed temporary one
+    constexpr uint32_t fileEventsMask = IN_CLOSE_WRITE | IN_MOVED_TO;
+    constexpr uint32_t watchMask = fileEventsMask | IN_CREATE | IN_ONLYDIR;
+}
+#endif
+
+FileWatcher::FileWatcher(const FilePath& directory, std::vector<FilePath> aExcludedDirectories /* = {} */)
+    : rootDirectory{ directory.GetAbsolute() }
+{
+    std::ranges::transform(aExcludedDirectories, std::back_inserter(excludedDirectories), [](const FilePath& path) {
+        return std::filesystem::path(path.GetAbsolute());
+    });
+
+#ifdef __linux__
+    fileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (fileDescriptor == -1)
+    {
+        LogW << "Failed to initialize inotify, " << directory << " changes won't be tracked\n";
+        return;
+    }
+
+    AddWatches(rootDirectory);
+#else
+    LogW << "File watching is not supported on this platform, " << directory << " changes won't be tracked\n";
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+    if (fileDescriptor != -1)
+    {
+        // Closing the descriptor removes all of its watches
+        close(fileDescriptor);
+    }
+#endif
+}
+
+FileWatcher::Changes FileWatcher::PollChanges()
+{
+    std::set<std::string> changes;
+    bool overflow = false;
+
+#ifdef __linux__
+    using namespace FileWatcherDetails;
+
+    if (fileDescriptor == -1)
+    {
+        return {};
+    }
+
+    alignas(inotify_event) std::array<char, 4096> buffer;
+
+    // Descriptor is non-blocking, read fails with EAGAIN once the queue is drained
+    for (ssize_t length = read(fileDescriptor, buffer.data(), buffer.size()); length > 0;
+        length = read(fileDescriptor, buffer.data(), buffer.size()))
+    {
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                overflow = true;
+                continue;
+            }
+
+            const auto it = watchedDirectories.find(event->wd);
+            if (event->len == 0 || it == watchedDirectories.end())
+            {
+                continue;
+            }
+
+            const std::filesystem::path path = it->second / event->name;
+
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    AddWatches(rootDirectory / path);
+                }
+            }
+            else if (event->mask & fileEventsMask)
+            {
+                changes.insert(path.generic_string());
+            }
+        }
+    }
+
+    // Directories created meanwhile might be among the dropped events, already watched ones keep their watches
+    if (overflow)
+    {
+        LogW << "File watcher queue overflowed, all of " << rootDirectory << " is considered changed\n";
+        AddWatches(rootDirectory);
+    }
+#endif
+
+    return { { changes.begin(), changes.end() }, overflow };
+}
+
+void FileWatcher::AddWatches([[maybe_unused]] const std::filesystem::path& directory)
+{
+#ifdef __linux__
+    using namespace FileWatcherDetails;
+
+    const auto addWatch = [&](const std::filesystem::path& path) {
+        const int watchDescriptor = inotify_add_watch(fileDescriptor, path.c_str(), watchMask);
+
+        if (watchDescriptor == -1)
+        {
+            LogW << "Failed to watch " << path << '\n';
+            return;
+        }
+
+        // Root itself maps to the empty path, so file paths don't start with "./"
+        const std::filesystem::path relativePath = path.lexically_relative(rootDirectory);
+        watchedDirectories[watchDescriptor] = relativePath == "." ? std::filesystem::path() : relativePath;
+    };
+
+    const auto isExcluded = [&](const std::filesystem::path& path) {
+        return std::ranges::find(excludedDirectories, path) != excludedDirectories.end();
+    };
+
+    if (isExcluded(directory))
+    {
+        return;
+    }
+
+    addWatch(directory);
+
+    for (auto it = std::filesystem::recursive_directory_iterator(directory);
+        it != std::filesystem::recursive_directory_iterator(); ++it)
+    {
+        if (!it->is_directory())
+        {
+            continue;
+        }
+
+        if (isExcluded(it->path()))
+        {
+            it.disable_recursion_pending();
+            continue;
+        }
+
+        addWatch(it->path());
+    }
+#endif
+}
\ No newline at end of file
@@ -21,6 +21,8 @@ namespace EngineDetails
 Engine::Engine(const std::string_view executablePath)
 {
     using namespace EngineConfig;
+
+    const auto startupStart = std::chrono::high_resolution_clock::now();
     
     FilePath::SetExecutablePath(executablePath);
     
@@ -35,6 +37,14 @@ Engine::Engine(const std::string_view executablePath)
 
     scene = std::make_unique<Scene>(FilePath(defaultScenePath), *vulkanContext);
     eventSystem->Fire<ES::SceneOpened>({ *scene });
+
+    // All of the startup pipelines are created by now, so it's the place to compare cold and warm cache launches
+    const PipelineCacheStats pipelineStats = vulkanContext->GetPipelineCache().GetStats();
+    const float startupSeconds = EngineDetails::GetDeltaSeconds(startupStart,
+        std::chrono::high_resolution_clock::now());
+
+    LogI << "Startup took " << startupSeconds << " s, " << pipelineStats.pipelineCount << " pipelines created in "
+        << pipelineStats.creationTimeMs << " ms with " << (pipelineStats.warm ? "warm" : "cold") << " pipeline cache\n";
 }
 
 Engine::~Engine()
@@ -4,6 +4,7 @@
 
 #include "Engine/Render/Renderer.hpp"
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
 #include "Engine/Render/Vulkan/Image/RenderTarget.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderModule.hpp"
 #include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
@@ -35,7 +36,9 @@ public:
     void Render(const Frame& frame) override;
 
 private:
-    void CreatePipeline(ShaderModule&& shaderModule);
+    // Static, so reload builds only use what they were given, see PipelineReloader::Start
+    static Pipeline CreatePipeline(ShaderModule&& shaderModule, VkDescriptorSetLayout descriptorSetLayout,
+        const VulkanContext& vulkanContext);
 
     void OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecreated& event);
     void OnSwapchainRecreated(const ES::SwapchainRecreated& event);
@@ -53,4 +56,6 @@ private:
 
     VkDescriptorSet descriptor;
     DescriptorSetLayout layout;
+
+    PipelineReloader pipelineReloader;
 };
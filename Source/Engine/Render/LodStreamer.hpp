@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Engine/Scene/SceneDataStructures.hpp"
+
+class SceneGeometry;
+
+// Pages finer lods in and out of scene geometry index and meshlet arenas following the lods culling requests for
+// each primitive slot, see PrimitiveCull.comp. Arenas work as a cache: lods stay resident until their space is needed
+// by requested ones, then the least recently requested are evicted. Coarsest lods are never evicted
+class LodStreamer
+{
+public:
+    struct Stats
+    {
+        uint32_t lodCount = 0;
+        uint32_t residentLodCount = 0;
+        uint32_t pendingLodCount = 0; // Requested by visible draws but not resident yet
+    };
+
+    // Makes as many lods resident right away as arenas fit, coarse to fine.
+    // Lods are uploaded from raw scene geometry, so it has to stay resident while streaming
+    LodStreamer(const RawScene& rawScene, std::span<const uint32_t> slots, SceneGeometry& geometry);
+    ~LodStreamer();
+
+    LodStreamer(const LodStreamer&) = delete;
+    LodStreamer& operator=(const LodStreamer&) = delete;
+
+    LodStreamer(LodStreamer&&) = delete;
+    LodStreamer& operator=(LodStreamer&&) = delete;
+
+    // False if all lods are resident, nothing has to be streamed then
+    bool IsStreaming() const;
+
+    // Requests are indexed by slot and come from a completed frame, so they lag a few frames behind.
+    // Call at the frame boundary, see SceneGeometry::BeginFrame. Uploads are left queued in scene geometry,
+    // see SceneGeometry::RecordUploads
+    void Update(std::span<const uint32_t> lodRequests);
+
+    const Stats& GetStats() const
+    {
+        return stats;
+    }
+
+private:
+    struct StreamedPrimitive
+    {
+        uint32_t slot = 0;
+        uint32_t lodCount = 0;
+        uint32_t requestedLod = 0;
+        uint64_t lastRequestFrame = 0;
+    };
+
+    // Space of evicted lods is free once frames in flight are done with them, so it's reused a few frames later
+    void Evict(size_t lodCount);
+
+    void UpdateStats();
+
+    const RawScene* rawScene = nullptr;
+    SceneGeometry* geometry = nullptr;
+
+    std::vector<StreamedPrimitive> primitives;
+    uint64_t frameCounter = 0;
+
+    Stats stats;
+};
\ No newline at end of file
@@ -40,18 +40,19 @@ namespace ComputeRendererDetails
 ComputeRenderer::ComputeRenderer(EventSystem& aEventSystem, const VulkanContext& aVulkanContext)
     : vulkanContext{ &aVulkanContext }
     , eventSystem{ &aEventSystem }
+    , pipelineReloader{ aVulkanContext }
 {
     using namespace ComputeRendererDetails;
 
+    // Shader compiles while the render target is being created
+    std::future<ShaderModule> shaderModule = vulkanContext->GetShaderManager().CreateShaderModuleAsync(
+        FilePath(shaderPath), ShaderType::eCompute);
+
     renderTarget = CreateRenderTarget(*vulkanContext);
     std::tie(descriptor, layout) = CreateRenderTargetDescriptor(renderTarget, *vulkanContext);
-    
-    const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
-    
-    ShaderModule shaderModule = shaderManager.CreateShaderModule(FilePath(shaderPath), ShaderType::eCompute);
-    Assert(shaderModule.IsValid());
 
-    CreatePipeline(std::move(shaderModule));
+    computePipeline = CreatePipeline(shaderModule.get(), layout, *vulkanContext);
+    Assert(computePipeline.IsValid());
 
     eventSystem->Subscribe<ES::BeforeSwapchainRecreated>(this, &ComputeRenderer::OnBeforeSwapchainRecreated);
     eventSystem->Subscribe<ES::SwapchainRecreated>(this, &ComputeRenderer::OnSwapchainRecreated);
@@ -71,47 +72,58 @@ void ComputeRenderer::Process(const Frame& frame, const float deltaSeconds)
 
 void ComputeRenderer::Render(const Frame& frame)
 {
-    using namespace ImageUtils;
+    // Frame boundary, nothing is recorded with the old pipeline yet
+    pipelineReloader.TryApply(std::span(&computePipeline, 1));
+
+    frame.recorder->Record([this, swapchainImageIndex = frame.swapchainImageIndex](VkCommandBuffer commandBuffer) {
+        using namespace ImageUtils;
     
-    const VkCommandBuffer commandBuffer = frame.commandBuffer;
-    const RenderTarget& swapchainTarget = vulkanContext->GetSwapchain().GetRenderTargets()[frame.swapchainImageIndex];
-    const VkExtent3D targetExtent = renderTarget.image.GetDescription().extent;
+        const RenderTarget& swapchainTarget = vulkanContext->GetSwapchain().GetRenderTargets()[swapchainImageIndex];
+        const VkExtent3D targetExtent = renderTarget.image.GetDescription().extent;
     
-    TransitionLayout(commandBuffer, renderTarget, LayoutTransitions::undefinedToGeneral, {
-        .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT });
+        TransitionLayout(commandBuffer, renderTarget, LayoutTransitions::undefinedToGeneral, {
+            .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT });
     
-    FillImage(commandBuffer, renderTarget, Color::magenta);
+        FillImage(commandBuffer, renderTarget, Color::magenta);
     
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline.GetLayout(), 0, 1, &descriptor, 0, nullptr);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline.GetLayout(),
+            0, 1, &descriptor, 0, nullptr);
 
-    const VkExtent3D groupCount = { static_cast<uint32_t>(std::ceil(targetExtent.width / 16.0)),
-        static_cast<uint32_t>(std::ceil(targetExtent.height / 16.0)), 1 };
+        const VkExtent3D groupCount = { static_cast<uint32_t>(std::ceil(targetExtent.width / 16.0)),
+            static_cast<uint32_t>(std::ceil(targetExtent.height / 16.0)), 1 };
 
-    vkCmdDispatch(commandBuffer, groupCount.width, groupCount.height, groupCount.depth);
+        vkCmdDispatch(commandBuffer, groupCount.width, groupCount.height, groupCount.depth);
     
-    TransitionLayout(commandBuffer, renderTarget, LayoutTransitions::generalToSrcOptimal, {
-        .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
-        .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT });
+        TransitionLayout(commandBuffer, renderTarget, LayoutTransitions::generalToSrcOptimal, {
+            .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT });
     
-    TransitionLayout(commandBuffer, swapchainTarget, LayoutTransitions::undefinedToDstOptimal, {
-        .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT });
+        TransitionLayout(commandBuffer, swapchainTarget, LayoutTransitions::undefinedToDstOptimal, {
+            .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT });
     
-    BlitImageToImage(commandBuffer, renderTarget, swapchainTarget);
+        BlitImageToImage(commandBuffer, renderTarget, swapchainTarget);
     
-    TransitionLayout(commandBuffer, swapchainTarget, LayoutTransitions::dstOptimalToColorAttachmentOptimal, {
-        .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT });
+        TransitionLayout(commandBuffer, swapchainTarget, LayoutTransitions::dstOptimalToColorAttachmentOptimal, {
+            .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT, .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT });
+    });
 }
 
-void ComputeRenderer::CreatePipeline(ShaderModule&& shaderModule)
+Pipeline ComputeRenderer::CreatePipeline(ShaderModule&& shaderModule,
+    const VkDescriptorSetLayout descriptorSetLayout, const VulkanContext& vulkanContext)
 {
     using namespace VulkanUtils;
 
-    std::vector<VkDescriptorSetLayout> layouts = { layout };
+    if (!shaderModule.IsValid())
+    {
+        return {};
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts = { descriptorSetLayout };
     
-    computePipeline = ComputePipelineBuilder(*vulkanContext)
+    return ComputePipelineBuilder(vulkanContext)
         .SetDescriptorSetLayouts(std::move(layouts))
         .SetShaderModule(std::move(shaderModule))
         .Build();
@@ -122,7 +134,7 @@ void ComputeRenderer::OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecrea
     DescriptorSetManager& descriptorSetManager = vulkanContext->GetDescriptorSetsManager();
     descriptorSetManager.ResetDescriptors(DescriptorScope::eComputeRenderer);
     
-    renderTarget.~RenderTarget();
+    vulkanContext->GetDeletionQueue().Enqueue(std::move(renderTarget));
 }
 
 void ComputeRenderer::OnSwapchainRecreated(const ES::SwapchainRecreated& event)
@@ -136,12 +148,20 @@ void ComputeRenderer::OnSwapchainRecreated(const ES::SwapchainRecreated& event)
 void ComputeRenderer::OnTryReloadShaders(const ES::TryReloadShaders& event)
 {
     using namespace ComputeRendererDetails;
-    
-    const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
 
-    if (ShaderModule shaderModule = shaderManager.CreateShaderModule(FilePath(shaderPath), ShaderType::eCompute);
-        shaderModule.IsValid())
+    if (!vulkanContext->GetShaderManager().IsShaderAffected(FilePath(shaderPath), event.changedFiles))
     {
-        CreatePipeline(std::move(shaderModule));
+        return;
     }
+
+    pipelineReloader.Start([&context = *vulkanContext,
+        descriptorSetLayout = static_cast<VkDescriptorSetLayout>(layout)]() {
+        const ShaderManager& shaderManager = context.GetShaderManager();
+
+        PipelineReloader::KeyedPipelines pipelines;
+        pipelines.emplace_back(0, CreatePipeline(shaderManager.CreateShaderModule(FilePath(shaderPath),
+            ShaderType::eCompute), descriptorSetLayout, context));
+
+        return pipelines;
+    });
 }
@@ -0,0 +1,164 @@
+#include "Engine/Render/LodStreamer.hpp"
+
+#include "Engine/Render/SceneGeometry.hpp"
+
+namespace LodStreamerDetails
+{
+    // Refinements of the frame share its staging buffer, so this bounds the per frame copy
+    static constexpr size_t maxRefinedLodsPerFrame = 256;
+}
+
+LodStreamer::LodStreamer(const RawScene& aRawScene, const std::span<const uint32_t> slots, SceneGeometry& aGeometry)
+    : rawScene{ &aRawScene }
+    , geometry{ &aGeometry }
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i] != SceneGeometry::invalidSlot)
+        {
+            const uint32_t lodCount = rawScene->primitives[i].lodCount;
+
+            primitives.push_back({ .slot = slots[i], .lodCount = lodCount, .requestedLod = lodCount - 1 });
+        }
+    }
+
+    // Level by level, so all primitives get their finer lods before any of them gets the finest one
+    std::vector<uint32_t> refinableSlots;
+
+    while (true)
+    {
+        refinableSlots.clear();
+
+        for (const StreamedPrimitive& primitive : primitives)
+        {
+            if (geometry->GetFinestResidentLod(primitive.slot) > 0)
+            {
+                refinableSlots.push_back(primitive.slot);
+            }
+        }
+
+        if (refinableSlots.empty())
+        {
+            break;
+        }
+
+        const size_t refinedCount = geometry->RefineLods(*rawScene, refinableSlots);
+
+        // Scene is loading, so levels are uploaded right away to keep the staging memory to a single level
+        geometry->SubmitUploads();
+
+        if (refinedCount < refinableSlots.size())
+        {
+            break;
+        }
+    }
+
+    UpdateStats();
+}
+
+LodStreamer::~LodStreamer() = default;
+
+bool LodStreamer::IsStreaming() const
+{
+    return std::ranges::any_of(primitives, [&](const StreamedPrimitive& primitive) {
+        return geometry->GetFinestResidentLod(primitive.slot) > 0;
+    });
+}
+
+void LodStreamer::Update(const std::span<const uint32_t> lodRequests)
+{
+    using namespace LodStreamerDetails;
+
+    ++frameCounter;
+
+    // Primitives that are not visible keep their last request until they are evicted
+    for (StreamedPrimitive& primitive : primitives)
+    {
+        if (const uint32_t request = lodRequests[primitive.slot]; request != gpu::lodNotRequested)
+        {
+            primitive.requestedLod = std::min(request, primitive.lodCount - 1);
+            primitive.lastRequestFrame = frameCounter;
+        }
+    }
+
+    std::vector<const StreamedPrimitive*> refinable;
+
+    for (const StreamedPrimitive& primitive : primitives)
+    {
+        if (primitive.lastRequestFrame == frameCounter
+            && geometry->GetFinestResidentLod(primitive.slot) > primitive.requestedLod)
+        {
+            refinable.push_back(&primitive);
+        }
+    }
+
+    if (!refinable.empty())
+    {
+        // One lod per primitive per frame, the ones furthest from their request go first
+        const auto getMissingLodCount = [&](const StreamedPrimitive* primitive) {
+            return geometry->GetFinestResidentLod(primitive->slot) - primitive->requestedLod;
+        };
+
+        std::ranges::sort(refinable, std::ranges::greater(), getMissingLodCount);
+
+        refinable.resize(std::min(refinable.size(), maxRefinedLodsPerFrame));
+
+        std::vector<uint32_t> slots;
+        slots.reserve(refinable.size());
+
+        std::ranges::transform(refinable, std::back_inserter(slots), &StreamedPrimitive::slot);
+
+        if (const size_t refinedCount = geometry->RefineLods(*rawScene, slots); refinedCount < slots.size())
+        {
+            Evict(slots.size() - refinedCount);
+        }
+    }
+
+    UpdateStats();
+}
+
+void LodStreamer::Evict(const size_t lodCount)
+{
+    std::vector<const StreamedPrimitive*> evictable;
+
+    // Lods finer than requested and lods of the primitives that are not visible right now aren't needed
+    for (const StreamedPrimitive& primitive : primitives)
+    {
+        const uint32_t finestResidentLod = geometry->GetFinestResidentLod(primitive.slot);
+
+        if (finestResidentLod + 1 < primitive.lodCount
+            && (finestResidentLod < primitive.requestedLod || primitive.lastRequestFrame != frameCounter))
+        {
+            evictable.push_back(&primitive);
+        }
+    }
+
+    std::ranges::sort(evictable, std::ranges::less(), &StreamedPrimitive::lastRequestFrame);
+
+    evictable.resize(std::min(evictable.size(), lodCount));
+
+    std::vector<uint32_t> slots;
+    slots.reserve(evictable.size());
+
+    std::ranges::transform(evictable, std::back_inserter(slots), &StreamedPrimitive::slot);
+
+    geometry->CoarsenLods(slots);
+}
+
+void LodStreamer::UpdateStats()
+{
+    stats = {};
+
+    for (const StreamedPrimitive& primitive : primitives)
+    {
+        const uint32_t finestResidentLod = geometry->GetFinestResidentLod(primitive.slot);
+
+        stats.lodCount += primitive.lodCount;
+        stats.residentLodCount += primitive.lodCount - finestResidentLod;
+
+        if (primitive.lastRequestFrame == frameCounter && finestResidentLod > primitive.requestedLod)
+        {
+            stats.pendingLodCount += finestResidentLod - primitive.requestedLod;
+        }
+    }
+}
\ No newline at end of file
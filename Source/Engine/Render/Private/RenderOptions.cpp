@@ -31,6 +31,9 @@ RenderOptions::RenderOptions(const VulkanContext& aVulkanContext, EventSystem& a
     // it won't be verified on construction - that's why we're setting it here
     // and it will do the check inside the setter, better approach - clamp on load
     SetGraphicsPipelineType(GraphicsPipelineType::eMesh);
+
+    // Higher counts cost a lot of memory and bandwidth for little visual gain
+    SetSampleCount(std::min(VK_SAMPLE_COUNT_4_BIT, vulkanContext->GetDevice().GetProperties().maxSampleCount));
     
     eventSystem->Subscribe<ES::KeyInput>(this, &RenderOptions::OnKeyInput);
 }
@@ -50,6 +53,16 @@ bool RenderOptions::IsGraphicsPipelineTypeSupported(GraphicsPipelineType aGraphi
     return true;
 }
 
+bool RenderOptions::IsShaderOptimizationSupported() const
+{
+    return ShaderCompiler::IsOptimizerAvailable();
+}
+
+bool RenderOptions::IsSampleCountSupported(const VkSampleCountFlagBits aSampleCount) const
+{
+    return (vulkanContext->GetDevice().GetProperties().supportedSampleCounts & aSampleCount) != 0;
+}
+
 RendererType RenderOptions::GetRendererType() const
 {
     return rendererType;
@@ -95,6 +108,71 @@ void RenderOptions::SetFreezeCamera(const bool aFreezeCamera)
     freezeCamera = aFreezeCamera;
 }
 
+DrawSortMode RenderOptions::GetDrawSortMode() const
+{
+    return drawSortMode;
+}
+
+void RenderOptions::SetDrawSortMode(const DrawSortMode aDrawSortMode)
+{
+    drawSortMode = aDrawSortMode;
+}
+
+DebugView RenderOptions::GetDebugView() const
+{
+    return debugView;
+}
+
+void RenderOptions::SetDebugView(const DebugView aDebugView)
+{
+    debugView = aDebugView;
+}
+
+VkSampleCountFlagBits RenderOptions::GetSampleCount() const
+{
+    return sampleCount;
+}
+
+void RenderOptions::SetSampleCount(const VkSampleCountFlagBits aSampleCount)
+{
+    if (!IsSampleCountSupported(aSampleCount))
+    {
+        return;
+    }
+
+    sampleCount = aSampleCount;
+}
+
+RawSceneResidency RenderOptions::GetRawSceneResidency() const
+{
+    return rawSceneResidency;
+}
+
+void RenderOptions::SetRawSceneResidency(const RawSceneResidency aRawSceneResidency)
+{
+    rawSceneResidency = aRawSceneResidency;
+}
+
+bool RenderOptions::GetReuseCommands() const
+{
+    return reuseCommands;
+}
+
+void RenderOptions::SetReuseCommands(const bool aReuseCommands)
+{
+    reuseCommands = aReuseCommands;
+}
+
+bool RenderOptions::GetOptimizeShaders() const
+{
+    return optimizeShaders;
+}
+
+void RenderOptions::SetOptimizeShaders(const bool aOptimizeShaders)
+{
+    optimizeShaders = aOptimizeShaders;
+}
+
 void RenderOptions::OnKeyInput(const ES::KeyInput& event)
 {
     if (event.key == Key::eF1 && event.action == KeyAction::ePress)
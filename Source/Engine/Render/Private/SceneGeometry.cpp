@@ -0,0 +1,522 @@
+#include "Engine/Render/SceneGeometry.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/CommandRecorder.hpp"
+#include "Engine/Render/Vulkan/Synchronization/SynchronizationUtils.hpp"
+
+namespace SceneGeometryDetails
+{
+    // Frames in flight might still read the primitives that are about to be patched
+    static constexpr PipelineBarrier beforeUploadBarrier = {
+        .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+            | VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT,
+        .srcAccessMask = 0,
+        .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT };
+
+    // Culling reads primitives and lods, then draws read indices and meshlets
+    static constexpr PipelineBarrier afterUploadBarrier = {
+        .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+            | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT
+            | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT };
+
+    struct Range
+    {
+        uint32_t offset = std::numeric_limits<uint32_t>::max();
+        uint32_t end = 0;
+
+        uint32_t GetSize() const
+        {
+            return end > offset ? end - offset : 0;
+        }
+
+        void Add(const uint32_t rangeOffset, const uint32_t rangeSize)
+        {
+            offset = std::min(offset, rangeOffset);
+            end = std::max(end, rangeOffset + rangeSize);
+        }
+    };
+
+    // Source ranges of the lod in raw scene, all of them are contiguous, see SceneHelpers
+    struct LodRanges
+    {
+        Range indices; // In raw scene short indices if the lod has bShortIndices
+        Range meshlets;
+        Range meshletData;
+    };
+
+    static uint32_t GetMeshletDataSize(const gpu::Meshlet& meshlet)
+    {
+        const uint32_t vertexOffsetsSize = meshlet.bShortVertexOffsets ? (meshlet.vertexCount + 1) / 2 
+            : meshlet.vertexCount;
+
+        return vertexOffsetsSize + (meshlet.triangleCount * 3 + 3) / 4;
+    }
+
+    static LodRanges GetLodRanges(const RawScene& rawScene, const gpu::Lod& lod)
+    {
+        LodRanges ranges;
+
+        ranges.indices.Add(lod.indexOffset, lod.indexCount);
+        ranges.meshlets.Add(lod.meshletOffset, lod.meshletCount);
+
+        for (uint32_t i = lod.meshletOffset; i < lod.meshletOffset + lod.meshletCount; ++i)
+        {
+            ranges.meshletData.Add(rawScene.meshlets[i].dataOffset, GetMeshletDataSize(rawScene.meshlets[i]));
+        }
+
+        return ranges;
+    }
+
+    template <typename T>
+    static std::span<const std::byte> GetBytes(const std::vector<T>& data, const Range& range)
+    {
+        return std::as_bytes(std::span(data).subspan(range.offset, range.GetSize()));
+    }
+
+    static Buffer CreateArenaBuffer(const size_t size, const VkBufferUsageFlags usage, 
+        const VulkanContext& vulkanContext)
+    {
+        if (size == 0)
+        {
+            return {};
+        }
+
+        const BufferDescription description = {
+            .size = size,
+            .usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eGeometry };
+
+        return Buffer(description, false, vulkanContext);
+    }
+}
+
+SceneGeometry::SceneGeometry(const Capacity& capacity, const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+    , slotCapacity{ capacity.primitiveCount }
+{
+    using namespace SceneGeometryDetails;
+
+    const auto createArena = [&](Arena& arena, const uint32_t count, const uint32_t elementSize,
+        const VkBufferUsageFlags usage) {
+        arena.buffer = CreateArenaBuffer(static_cast<size_t>(count) * elementSize, usage, *vulkanContext);
+        arena.allocator = OffsetAllocator(count);
+        arena.elementSize = elementSize;
+    };
+
+    createArena(vertices, capacity.vertexCount, sizeof(gpu::Vertex),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    createArena(indices, capacity.indexCount, sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    createArena(shortIndices, capacity.shortIndexCount, sizeof(uint16_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    createArena(meshlets, capacity.meshletCount, sizeof(gpu::Meshlet), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    createArena(meshletData, capacity.meshletDataCount, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    primitiveBuffer = CreateArenaBuffer(capacity.primitiveCount * sizeof(gpu::Primitive),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, *vulkanContext);
+    lodBuffer = CreateArenaBuffer(capacity.primitiveCount * gpu::maxLodCount * sizeof(gpu::Lod),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, *vulkanContext);
+
+    residentPrimitives.reserve(capacity.primitiveCount);
+
+    for (Buffer* buffer : { &vertices.buffer, &indices.buffer, &shortIndices.buffer, &meshlets.buffer,
+        &meshletData.buffer, &primitiveBuffer, &lodBuffer })
+    {
+        if (buffer->IsValid())
+        {
+            vulkanContext->GetMemoryManager().RegisterRelocatable(*buffer);
+        }
+    }
+}
+
+SceneGeometry::~SceneGeometry()
+{
+    // Frames in flight might still use arenas, so let the deletion queue handle them instead of waiting
+    DeletionQueue& deletionQueue = vulkanContext->GetDeletionQueue();
+
+    for (Buffer* buffer : { &vertices.buffer, &indices.buffer, &shortIndices.buffer, &meshlets.buffer,
+        &meshletData.buffer, &primitiveBuffer, &lodBuffer })
+    {
+        if (buffer->IsValid())
+        {
+            vulkanContext->GetMemoryManager().UnregisterRelocatable(*buffer);
+            deletionQueue.Enqueue(std::move(*buffer));
+        }
+    }
+}
+
+std::vector<uint32_t> SceneGeometry::AddPrimitives(const RawScene& rawScene, 
+    const std::span<const uint32_t> primitiveIndices)
+{
+    using namespace SceneGeometryDetails;
+
+    std::vector<uint32_t> slots;
+    slots.reserve(primitiveIndices.size());
+
+    UploadBatch batch;
+    batch.meshlets.reserve(rawScene.meshlets.size());
+    batch.lods.reserve(primitiveIndices.size());
+
+    for (const uint32_t primitiveIndex : primitiveIndices)
+    {
+        const gpu::Primitive& primitive = rawScene.primitives[primitiveIndex];
+        const uint32_t coarsestLod = primitive.lodCount - 1;
+
+        ResidentPrimitive resident = { .primitive = primitive, .primitiveIndex = primitiveIndex };
+
+        const uint32_t slot = AllocateSlot();
+        const std::array vertexRequest = { AllocationRequest{ &vertices, &resident.vertices, primitive.vertexCount } };
+
+        if (slot == invalidSlot || !Allocate(vertexRequest) || !AddLod(resident, slot, coarsestLod, rawScene, batch))
+        {
+            if (resident.vertices.IsValid())
+            {
+                vertices.allocator.Free(resident.vertices);
+            }
+
+            if (slot != invalidSlot)
+            {
+                freeSlots.push_back(slot);
+            }
+
+            LogW << "Scene geometry is out of space, primitive " << primitiveIndex << " is not resident\n";
+
+            slots.push_back(invalidSlot);
+            continue;
+        }
+
+        // Source offsets are absolute in raw scene, rebase them onto the arena allocations
+        resident.primitive.vertexOffset = resident.vertices.offset;
+        resident.primitive.finestResidentLod = coarsestLod;
+
+        residentPrimitives[slot] = resident;
+        slots.push_back(slot);
+
+        const Range vertexRange = { primitive.vertexOffset, primitive.vertexOffset + primitive.vertexCount };
+
+        batch.regions.push_back({ &vertices.buffer, GetBytes(rawScene.vertices, vertexRange),
+            vertices.GetByteOffset(resident.vertices) });
+
+        pendingUploads.primitiveSlots.push_back(slot);
+    }
+
+    QueueUpload(batch.regions);
+    SubmitUploads();
+
+    return slots;
+}
+
+size_t SceneGeometry::RefineLods(const RawScene& rawScene, const std::span<const uint32_t> slots)
+{
+    UploadBatch batch;
+    batch.meshlets.reserve(rawScene.meshlets.size());
+    batch.lods.reserve(slots.size());
+
+    size_t refinedCount = 0;
+
+    for (const uint32_t slot : slots)
+    {
+        ResidentPrimitive& resident = residentPrimitives[slot];
+        Assert(resident.primitive.finestResidentLod > 0);
+
+        if (!AddLod(resident, slot, resident.primitive.finestResidentLod - 1, rawScene, batch))
+        {
+            break;
+        }
+
+        ++refinedCount;
+    }
+
+    QueueUpload(batch.regions);
+
+    // Primitives are copied in the same batch as the lods, so culling never sees a lod before its data
+    for (const uint32_t slot : slots.first(refinedCount))
+    {
+        --residentPrimitives[slot].primitive.finestResidentLod;
+
+        pendingUploads.primitiveSlots.push_back(slot);
+    }
+
+    return refinedCount;
+}
+
+void SceneGeometry::CoarsenLods(const std::span<const uint32_t> slots)
+{
+    for (const uint32_t slot : slots)
+    {
+        ResidentPrimitive& resident = residentPrimitives[slot];
+        uint32_t& finestResidentLod = resident.primitive.finestResidentLod;
+
+        Assert(finestResidentLod + 1 < resident.primitive.lodCount);
+
+        ResidentLod& lod = resident.lods[finestResidentLod];
+
+        ReleaseLater(*lod.indexArena, lod.indices);
+        ReleaseLater(meshlets, lod.meshlets);
+        ReleaseLater(meshletData, lod.meshletData);
+
+        ++finestResidentLod;
+
+        pendingUploads.primitiveSlots.push_back(slot);
+    }
+}
+
+void SceneGeometry::RecordUploads(CommandRecorder& recorder)
+{
+    auto [stagingBuffer, copies] = TakePendingUploads();
+
+    if (!stagingBuffer.IsValid())
+    {
+        return;
+    }
+
+    recorder.Record([source = static_cast<VkBuffer>(stagingBuffer), copies = std::move(copies)](
+        const VkCommandBuffer cmd) {
+        RecordCopies(cmd, source, copies);
+    });
+
+    // Destroyed once the frame comes around again, the copy is done by then
+    vulkanContext->GetDeletionQueue().Enqueue(std::move(stagingBuffer));
+}
+
+void SceneGeometry::SubmitUploads()
+{
+    const auto [stagingBuffer, copies] = TakePendingUploads();
+
+    if (!stagingBuffer.IsValid())
+    {
+        return;
+    }
+
+    vulkanContext->GetDevice().ExecuteOneTimeCommandBuffer([&](const VkCommandBuffer cmd) {
+        RecordCopies(cmd, stagingBuffer, copies);
+    });
+}
+
+uint32_t SceneGeometry::GetFinestResidentLod(const uint32_t slot) const
+{
+    return residentPrimitives[slot].primitive.finestResidentLod;
+}
+
+void SceneGeometry::RemovePrimitive(const uint32_t slot)
+{
+    Assert(slot < residentPrimitives.size() && residentPrimitives[slot].vertices.IsValid());
+
+    ResidentPrimitive& resident = residentPrimitives[slot];
+
+    ReleaseLater(vertices, resident.vertices);
+
+    for (ResidentLod& lod : resident.lods)
+    {
+        if (lod.indexArena)
+        {
+            ReleaseLater(*lod.indexArena, lod.indices);
+        }
+
+        ReleaseLater(meshlets, lod.meshlets);
+        ReleaseLater(meshletData, lod.meshletData);
+    }
+
+    pendingSlots[currentFrame].push_back(slot);
+}
+
+void SceneGeometry::BeginFrame(const uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    for (const auto& [arena, allocation] : pendingReleases[frameIndex])
+    {
+        arena->allocator.Free(allocation);
+    }
+
+    pendingReleases[frameIndex].clear();
+
+    freeSlots.insert(freeSlots.end(), pendingSlots[frameIndex].begin(), pendingSlots[frameIndex].end());
+    pendingSlots[frameIndex].clear();
+}
+
+uint32_t SceneGeometry::AllocateSlot()
+{
+    if (!freeSlots.empty())
+    {
+        const uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+
+        return slot;
+    }
+
+    if (residentPrimitives.size() == slotCapacity)
+    {
+        return invalidSlot;
+    }
+
+    residentPrimitives.emplace_back();
+
+    return static_cast<uint32_t>(residentPrimitives.size() - 1);
+}
+
+bool SceneGeometry::Allocate(const std::span<const AllocationRequest> requests)
+{
+    for (const auto& [arena, allocation, size] : requests)
+    {
+        if (size == 0)
+        {
+            continue;
+        }
+
+        *allocation = arena->allocator.Allocate(size);
+
+        if (!allocation->IsValid())
+        {
+            // Roll back what's allocated so far
+            for (const auto& [allocatedArena, allocated, allocatedSize] : requests)
+            {
+                if (allocated->IsValid())
+                {
+                    allocatedArena->allocator.Free(*allocated);
+                    *allocated = {};
+                }
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SceneGeometry::AddLod(ResidentPrimitive& resident, const uint32_t slot, const uint32_t lodIndex,
+    const RawScene& rawScene, UploadBatch& batch)
+{
+    using namespace SceneGeometryDetails;
+
+    const gpu::Primitive& primitive = rawScene.primitives[resident.primitiveIndex];
+    const gpu::Lod& lod = rawScene.GetLods(resident.primitiveIndex)[lodIndex];
+    const LodRanges ranges = GetLodRanges(rawScene, lod);
+
+    ResidentLod& residentLod = resident.lods[lodIndex];
+    residentLod.indexArena = lod.bShortIndices ? &shortIndices : &indices;
+
+    const std::array requests = {
+        AllocationRequest{ residentLod.indexArena, &residentLod.indices, ranges.indices.GetSize() },
+        AllocationRequest{ &meshlets, &residentLod.meshlets, ranges.meshlets.GetSize() },
+        AllocationRequest{ &meshletData, &residentLod.meshletData, ranges.meshletData.GetSize() } };
+
+    if (!Allocate(requests))
+    {
+        return false;
+    }
+
+    // Source offsets are absolute in raw scene, rebase them onto the arena allocations
+    gpu::Lod& patchedLod = batch.lods.emplace_back(lod);
+    patchedLod.indexOffset = residentLod.indices.offset;
+
+    const std::span<const std::byte> indexBytes = lod.bShortIndices
+        ? GetBytes(rawScene.shortIndices, ranges.indices) : GetBytes(rawScene.indices, ranges.indices);
+
+    batch.regions.push_back({ &residentLod.indexArena->buffer, indexBytes,
+        residentLod.indexArena->GetByteOffset(residentLod.indices) });
+
+    if (ranges.meshlets.GetSize() > 0)
+    {
+        patchedLod.meshletOffset = residentLod.meshlets.offset;
+
+        const size_t firstPatchedMeshlet = batch.meshlets.size();
+
+        for (uint32_t i = ranges.meshlets.offset; i < ranges.meshlets.end; ++i)
+        {
+            gpu::Meshlet& meshlet = batch.meshlets.emplace_back(rawScene.meshlets[i]);
+
+            meshlet.firstVertexOffset = meshlet.firstVertexOffset - primitive.vertexOffset + resident.vertices.offset;
+            meshlet.dataOffset = meshlet.dataOffset - ranges.meshletData.offset + residentLod.meshletData.offset;
+        }
+
+        const auto meshletBytes = std::as_bytes(std::span(batch.meshlets).subspan(firstPatchedMeshlet));
+
+        batch.regions.push_back({ &meshlets.buffer, meshletBytes, meshlets.GetByteOffset(residentLod.meshlets) });
+        batch.regions.push_back({ &meshletData.buffer, GetBytes(rawScene.meshletData, ranges.meshletData),
+            meshletData.GetByteOffset(residentLod.meshletData) });
+    }
+
+    batch.regions.push_back({ &lodBuffer, std::as_bytes(std::span(&patchedLod, 1)),
+        (slot * gpu::maxLodCount + lodIndex) * sizeof(gpu::Lod) });
+
+    return true;
+}
+
+void SceneGeometry::ReleaseLater(Arena& arena, OffsetAllocator::Allocation& allocation)
+{
+    if (allocation.IsValid())
+    {
+        pendingReleases[currentFrame].push_back({ &arena, allocation });
+        allocation = {};
+    }
+}
+
+void SceneGeometry::QueueUpload(const std::span<const UploadRegion> regions)
+{
+    for (const UploadRegion& region : regions)
+    {
+        if (!region.data.empty())
+        {
+            QueueCopy(*region.destination, region.data, region.offset);
+        }
+    }
+}
+
+void SceneGeometry::QueueCopy(const Buffer& destination, const std::span<const std::byte> data,
+    const VkDeviceSize offset)
+{
+    const VkBufferCopy region = { .srcOffset = pendingUploads.data.size(), .dstOffset = offset, .size = data.size() };
+
+    pendingUploads.data.insert(pendingUploads.data.end(), data.begin(), data.end());
+    pendingUploads.copies.push_back({ &destination, region });
+}
+
+std::pair<Buffer, std::vector<SceneGeometry::PendingCopy>> SceneGeometry::TakePendingUploads()
+{
+    // Slot might be patched several times, copies of a single batch are unordered so it's written once
+    std::ranges::sort(pendingUploads.primitiveSlots);
+    const auto [first, last] = std::ranges::unique(pendingUploads.primitiveSlots);
+    pendingUploads.primitiveSlots.erase(first, last);
+
+    for (const uint32_t slot : pendingUploads.primitiveSlots)
+    {
+        QueueCopy(primitiveBuffer, std::as_bytes(std::span(&residentPrimitives[slot].primitive, 1)),
+            slot * sizeof(gpu::Primitive));
+    }
+
+    PendingUploads uploads = std::exchange(pendingUploads, {});
+
+    if (uploads.data.empty())
+    {
+        return {};
+    }
+
+    const BufferDescription stagingBufferDescription = {
+        .size = uploads.data.size(),
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        .category = MemoryCategory::eStaging };
+
+    return { Buffer(stagingBufferDescription, false, std::span<const std::byte>(uploads.data), *vulkanContext),
+        std::move(uploads.copies) };
+}
+
+void SceneGeometry::RecordCopies(const VkCommandBuffer cmd, const VkBuffer stagingBuffer,
+    const std::span<const PendingCopy> copies)
+{
+    using namespace SceneGeometryDetails;
+
+    SynchronizationUtils::SetMemoryBarrier(cmd, beforeUploadBarrier);
+
+    for (const auto& [destination, region] : copies)
+    {
+        vkCmdCopyBuffer(cmd, stagingBuffer, *destination, 1, &region);
+    }
+
+    SynchronizationUtils::SetMemoryBarrier(cmd, afterUploadBarrier);
+}
\ No newline at end of file
@@ -1,12 +1,16 @@
 #include "Engine/Render/SceneRenderer.hpp"
 
+#include <bit>
+
 #include "Engine/EventSystem.hpp"
+#include "Engine/Render/LodStreamer.hpp"
 #include "Engine/Scene/SceneHelpers.hpp"
 #include "Engine/Render/RenderOptions.hpp"
 #include "Engine/Render/Vulkan/VulkanConfig.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Buffer/BufferUtils.hpp"
 #include "Engine/Render/RenderStages/ForwardStage.hpp"
+#include "Engine/Render/RenderStages/DrawSortStage.hpp"
 #include "Engine/Render/RenderStages/PrimitiveCullStage.hpp"
 
 namespace SceneRendererDetails
@@ -17,12 +21,47 @@ namespace SceneRendererDetails
 
         for (const gpu::Draw& draw : draws)
         {
-            totalTriangles += rawScene.primitives[draw.primitiveIndex].lods[0].indexCount / 3;
+            totalTriangles += rawScene.GetLods(draw.primitiveIndex)[0].indexCount / 3;
         }
 
         Scene::SetTotalTriangles(totalTriangles);
     }
 
+    static DescriptorSetLayout CreateFrameDataDescriptorSetLayout(const VulkanContext& vulkanContext)
+    {
+        VkShaderStageFlags shaderStages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+        if (vulkanContext.GetDevice().GetProperties().meshShadersSupported)
+        {
+            shaderStages |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+        }
+
+        return vulkanContext.GetDescriptorSetsManager().GetDescriptorSetLayoutBuilder()
+            .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, shaderStages) // FrameDataBuffer
+            .Build();
+    }
+
+    static void CreateFrameDataBuffers(RenderContext& renderContext, const VulkanContext& vulkanContext)
+    {
+        renderContext.frameDataDescriptorSetLayout = CreateFrameDataDescriptorSetLayout(vulkanContext);
+
+        const BufferDescription frameDataBufferDescription = {
+            .size = sizeof(gpu::FrameData),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+        for (uint32_t i = 0; i < VulkanConfig::maxFramesInFlight; ++i)
+        {
+            renderContext.frameDataBuffers[i] = Buffer(frameDataBufferDescription, false, vulkanContext);
+            std::ignore = renderContext.frameDataBuffers[i].MapMemory(); // persistent mapping
+
+            std::tie(renderContext.frameDataDescriptorSets[i], std::ignore) = vulkanContext.GetDescriptorSetsManager()
+                .GetDescriptorSetBuilder(renderContext.frameDataDescriptorSetLayout)
+                .Bind(0, renderContext.frameDataBuffers[i])
+                .Build();
+        }
+    }
+
     void CreateIndirectBuffers(RenderContext& renderContext, const VulkanContext& vulkanContext)
     {
         const bool meshShadersSupported = vulkanContext.GetDevice().GetProperties().meshShadersSupported;
@@ -31,89 +70,288 @@ namespace SceneRendererDetails
             ? std::max(sizeof(gpu::IndirectCommand), sizeof(gpu::TaskCommand))
             : sizeof(gpu::IndirectCommand));
 
-        const std::vector<uint32_t> commandCountValues = { 0, 1, 1 };
+        const std::vector<uint32_t> commandCountValues = { 0, 1, 1, 0 };
         const std::span commandCountSpan(commandCountValues);
 
         // We use it as buffer for vkCmdDrawMeshTasksIndirectEXT, so let's just always allocate 2 more uint32_t values
-        // and set to them to 1 once on initialization bc we have 1-dimensional dispatch for tasks anyway
+        // and set to them to 1 once on initialization bc we have 1-dimensional dispatch for tasks anyway.
+        // The last one is the count of 16-bit index batch, see SHORT_COMMAND_COUNT_INDEX
         const BufferDescription commandCountBufferDescription = {
             .size = commandCountSpan.size_bytes(),
-            .usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+            .usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
 
         renderContext.commandCountBuffer = Buffer(commandCountBufferDescription, true, commandCountSpan, vulkanContext);
 
         const BufferDescription commandBufferDescription = {
             .size = largeEnoughCommandBuffer,
-            .usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+            .usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
 
         renderContext.commandBuffer = Buffer(commandBufferDescription, false, vulkanContext);
+
+        const BufferDescription unsortedCommandBufferDescription = {
+            .size = largeEnoughCommandBuffer,
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
+
+        renderContext.unsortedCommandBuffer = Buffer(unsortedCommandBufferDescription, false, vulkanContext);
+
+        const BufferDescription sortKeyBufferDescription = {
+            .size = gpu::primitiveCullMaxCommands * sizeof(uint32_t),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
+
+        renderContext.sortKeyBuffer = Buffer(sortKeyBufferDescription, false, vulkanContext);
     }
 
-    void CreateSceneBuffers(const RawScene& rawScene, RenderContext& renderContext, const VulkanContext& vulkanContext)
+    // Arenas are sized for the loaded scene plus headroom for primitives streamed in later, they don't grow
+    static constexpr float geometryArenaHeadroom = 1.5f;
+
+    // Shares of free device local memory. Lods that don't fit are streamed, vertices stay resident so primitives
+    // whose vertices don't fit are skipped, see SceneGeometry::AddPrimitives
+    static constexpr double lodArenaBudgetShare = 0.5;
+    static constexpr double vertexArenaBudgetShare = 0.25;
+
+    static VkDeviceSize GetArenaBudget(const double budgetShare, const VulkanContext& vulkanContext)
     {
-        const std::span verticesSpan(std::as_const(rawScene.vertices));
+        VkDeviceSize freeSize = 0;
 
-        const BufferDescription vertexBufferDescription = {
-            .size = verticesSpan.size_bytes(),
-            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+        for (const MemoryStats::Heap& heap : vulkanContext.GetMemoryManager().GetStats().heaps)
+        {
+            if (heap.deviceLocal && heap.budget > heap.usage)
+            {
+                freeSize = std::max(freeSize, heap.budget - heap.usage);
+            }
+        }
 
-        renderContext.vertexBuffer = Buffer(vertexBufferDescription, true, verticesSpan, vulkanContext);
+        if (freeSize == 0)
+        {
+            return std::numeric_limits<VkDeviceSize>::max();
+        }
 
-        const std::span indicesSpan(std::as_const(rawScene.indices));
+        return static_cast<VkDeviceSize>(static_cast<double>(freeSize) * budgetShare);
+    }
 
-        const BufferDescription indexBufferDescription = {
-            .size = indicesSpan.size_bytes(),
-            .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+    static SceneGeometry::Capacity GetGeometryCapacity(const RawScene& rawScene, const VulkanContext& vulkanContext)
+    {
+        const auto withHeadroom = [](const size_t count) {
+            return static_cast<uint32_t>(std::ceil(static_cast<float>(count) * geometryArenaHeadroom));
+        };
+
+        SceneGeometry::Capacity capacity = {
+            .vertexCount = withHeadroom(rawScene.vertices.size()),
+            .indexCount = withHeadroom(rawScene.indices.size()),
+            .shortIndexCount = withHeadroom(rawScene.shortIndices.size()),
+            .meshletCount = withHeadroom(rawScene.meshlets.size()),
+            .meshletDataCount = withHeadroom(rawScene.meshletData.size()),
+            .primitiveCount = withHeadroom(rawScene.primitives.size()) };
+
+        // Vertices are shared by all lods of a primitive and stay resident, the arena is capped by the budget anyway
+        const VkDeviceSize vertexArenaBudget = GetArenaBudget(vertexArenaBudgetShare, vulkanContext);
+        const auto maxVertexCount = static_cast<uint32_t>(std::min<VkDeviceSize>(
+            vertexArenaBudget / sizeof(gpu::Vertex), std::numeric_limits<uint32_t>::max()));
+
+        if (capacity.vertexCount > maxVertexCount)
+        {
+            LogI << "Scene vertices need " << capacity.vertexCount * sizeof(gpu::Vertex) / (1024 * 1024)
+                << " MB, arena is limited to " << vertexArenaBudget / (1024 * 1024) << " MB\n";
 
-        renderContext.indexBuffer = Buffer(indexBufferDescription, true, indicesSpan, vulkanContext);
+            capacity.vertexCount = maxVertexCount;
+        }
+
+        // Only index and meshlet arenas shrink below the scene size
+        const VkDeviceSize lodArenaSize = capacity.indexCount * sizeof(uint32_t)
+            + capacity.shortIndexCount * sizeof(uint16_t) + capacity.meshletCount * sizeof(gpu::Meshlet)
+            + capacity.meshletDataCount * sizeof(uint32_t);
+        const VkDeviceSize lodArenaBudget = GetArenaBudget(lodArenaBudgetShare, vulkanContext);
 
-        if (!rawScene.meshletData.empty())
+        if (lodArenaSize > lodArenaBudget)
         {
-            const std::span meshletDataSpan(std::as_const(rawScene.meshletData));
+            const double scale = static_cast<double>(lodArenaBudget) / static_cast<double>(lodArenaSize);
 
-            const BufferDescription meshletDataBufferDescription = {
-                .size = meshletDataSpan.size_bytes(),
-                .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+            const auto scaled = [&](const uint32_t count) {
+                return static_cast<uint32_t>(static_cast<double>(count) * scale);
+            };
 
-            renderContext.meshletDataBuffer = Buffer(meshletDataBufferDescription, true, meshletDataSpan, vulkanContext);
+            capacity.indexCount = scaled(capacity.indexCount);
+            capacity.shortIndexCount = scaled(capacity.shortIndexCount);
+            capacity.meshletCount = scaled(capacity.meshletCount);
+            capacity.meshletDataCount = scaled(capacity.meshletDataCount);
 
-            const std::span meshletSpan(std::as_const(rawScene.meshlets));
+            LogI << "Scene lods need " << lodArenaSize / (1024 * 1024) << " MB, arenas are limited to "
+                << lodArenaBudget / (1024 * 1024) << " MB\n";
+        }
 
-            const BufferDescription meshletBufferDescription = {
-                .size = meshletSpan.size_bytes(),
-                .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+        return capacity;
+    }
+
+    // Sort key is [primitive slot][depth] in 32 bits. Slot bits are whole bytes, so both key parts are sorted with
+    // an even number of 4 bit passes (see DrawSortStage), and depth gets everything that's left
+    static uint32_t GetSortDepthBits(const uint32_t slotCapacity)
+    {
+        constexpr uint32_t minDepthBits = 8;
+
+        // Largest slot is slotCapacity - 1, so exact powers of two don't need an extra bit
+        const uint32_t maxSlot = std::max(slotCapacity, 1u) - 1;
+        const auto slotBits = static_cast<uint32_t>(std::max((std::bit_width(maxSlot) + 7) / 8 * 8, 8));
+        Assert(slotBits <= 32 - minDepthBits);
+
+        return 32 - slotBits;
+    }
 
-            renderContext.meshletBuffer = Buffer(meshletBufferDescription, true, meshletSpan, vulkanContext);
+    // Every draw emits at most 1 vertex pipeline command, into the batch of the index type of its lod. Draws are
+    // counted for each index type their primitive has lods with, streamed lods included
+    static std::array<CommandBatch, 2> GetVertexCommandBatches(const RawScene& rawScene,
+        std::span<const gpu::Draw> draws)
+    {
+        std::vector<std::pair<bool, bool>> primitiveIndexTypes(rawScene.primitives.size());
+
+        for (size_t i = 0; i < rawScene.primitives.size(); ++i)
+        {
+            for (const gpu::Lod& lod : rawScene.GetLods(i))
+            {
+                (lod.bShortIndices ? primitiveIndexTypes[i].second : primitiveIndexTypes[i].first) = true;
+            }
         }
 
-        const std::span primitiveSpan(std::as_const(rawScene.primitives));
+        uint64_t commandCount = 0;
+        uint64_t shortCommandCount = 0;
+
+        for (const gpu::Draw& draw : draws)
+        {
+            const auto [longIndices, shortIndices] = primitiveIndexTypes[draw.primitiveIndex];
+
+            commandCount += longIndices ? 1 : 0;
+            shortCommandCount += shortIndices ? 1 : 0;
+        }
 
-        const BufferDescription primitiveBufferDescription = {
-            .size = primitiveSpan.size_bytes(),
-            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+        // Past the command buffer capacity the room is split in proportion, the commands left out are dropped
+        if (const uint64_t totalCount = commandCount + shortCommandCount; totalCount > gpu::primitiveCullMaxCommands)
+        {
+            LogW << "Vertex pipeline commands don't fit: " << totalCount << " requested, "
+                << gpu::primitiveCullMaxCommands << " available\n";
 
-        renderContext.primitiveBuffer = Buffer(primitiveBufferDescription, true, primitiveSpan, vulkanContext);
+            commandCount = commandCount * gpu::primitiveCullMaxCommands / totalCount;
+            shortCommandCount = gpu::primitiveCullMaxCommands - commandCount;
+        }
 
-        const std::vector<gpu::Draw> draws = SceneHelpers::GenerateDraws(rawScene);
-        renderContext.globals.drawCount = static_cast<uint32_t>(draws.size());
+        return { {
+            { gpu::commandCountIndex, 0, static_cast<uint32_t>(commandCount) },
+            { gpu::shortCommandCountIndex, static_cast<uint32_t>(commandCount),
+                static_cast<uint32_t>(shortCommandCount) } } };
+    }
+
+    // Returns slots of raw scene primitives in scene geometry
+    std::vector<uint32_t> CreateSceneBuffers(const RawScene& rawScene, RenderContext& renderContext,
+        const VulkanContext& vulkanContext)
+    {
+        renderContext.geometry = std::make_unique<SceneGeometry>(GetGeometryCapacity(rawScene, vulkanContext),
+            vulkanContext);
+
+        std::vector<uint32_t> primitiveIndices(rawScene.primitives.size());
+        std::iota(primitiveIndices.begin(), primitiveIndices.end(), 0);
+
+        const std::vector<uint32_t> slots = renderContext.geometry->AddPrimitives(rawScene, primitiveIndices);
+
+        std::vector<gpu::Draw> draws = SceneHelpers::GenerateDraws(rawScene);
 
         SetSceneStats(rawScene, draws);
 
+        std::erase_if(draws, [&](const gpu::Draw& draw) {
+            return slots[draw.primitiveIndex] == SceneGeometry::invalidSlot;
+        });
+
+        renderContext.vertexCommandBatches = GetVertexCommandBatches(rawScene, draws);
+
+        // Draws refer to primitives by their slots in scene geometry
+        for (gpu::Draw& draw : draws)
+        {
+            draw.primitiveIndex = slots[draw.primitiveIndex];
+        }
+
+        renderContext.globals.drawCount = static_cast<uint32_t>(draws.size());
+        renderContext.globals.sortDepthBits = GetSortDepthBits(renderContext.geometry->GetSlotCapacity());
+        renderContext.globals.shortCommandsOffset = renderContext.vertexCommandBatches[1].offset;
+
         const std::span drawSpan(std::as_const(draws));
 
         const BufferDescription drawBufferDescription = {
             .size = drawSpan.size_bytes(),
-            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eDraws };
 
         renderContext.drawBuffer = Buffer(drawBufferDescription, true, drawSpan, vulkanContext);
+
+        return slots;
+    }
+
+    static void CreateLodRequestBuffers(RenderContext& renderContext, const VulkanContext& vulkanContext)
+    {
+        const std::vector<uint32_t> lodRequests(renderContext.geometry->GetSlotCapacity(), gpu::lodNotRequested);
+        const std::span lodRequestSpan(lodRequests);
+
+        const BufferDescription lodRequestBufferDescription = {
+            .size = lodRequestSpan.size_bytes(),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
+
+        renderContext.lodRequestBuffer = Buffer(lodRequestBufferDescription, false, vulkanContext);
+
+        // Frames that haven't been submitted yet read no requests from them
+        const BufferDescription readbackBufferDescription = {
+            .size = lodRequestSpan.size_bytes(),
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            .category = MemoryCategory::eCommands };
+
+        for (Buffer& readbackBuffer : renderContext.lodRequestReadbackBuffers)
+        {
+            readbackBuffer = Buffer(readbackBufferDescription, false, lodRequestSpan, vulkanContext);
+            std::ignore = readbackBuffer.MapMemory(); // persistent mapping
+        }
+    }
+
+    // Shaders reach all scene buffers through these addresses, no descriptors needed.
+    // Updated again whenever defragmentation moves the buffers
+    static void SetBufferAddresses(RenderContext& renderContext)
+    {
+        const SceneGeometry& geometry = *renderContext.geometry;
+
+        gpu::FrameData& globals = renderContext.globals;
+        globals.vertices = geometry.GetVertexBuffer().GetDeviceAddress();
+        globals.primitives = geometry.GetPrimitiveBuffer().GetDeviceAddress();
+        globals.lods = geometry.GetLodBuffer().GetDeviceAddress();
+        globals.draws = renderContext.drawBuffer.GetDeviceAddress();
+
+        if (geometry.GetMeshletDataBuffer().IsValid())
+        {
+            globals.meshletData = geometry.GetMeshletDataBuffer().GetDeviceAddress();
+            globals.meshlets = geometry.GetMeshletBuffer().GetDeviceAddress();
+        }
+
+        globals.commandCount = renderContext.commandCountBuffer.GetDeviceAddress();
+        globals.commands = renderContext.commandBuffer.GetDeviceAddress();
+        globals.culledCommands = globals.commands; // See SceneRenderer::Process
+        globals.sortKeys = renderContext.sortKeyBuffer.GetDeviceAddress();
+        globals.lodRequests = renderContext.lodRequestBuffer.GetDeviceAddress();
+    }
+
+    // Scene geometry registers its arenas itself
+    static std::array<Buffer*, 6> GetRelocatableBuffers(RenderContext& renderContext)
+    {
+        return { &renderContext.drawBuffer, &renderContext.commandCountBuffer, &renderContext.commandBuffer,
+            &renderContext.unsortedCommandBuffer, &renderContext.sortKeyBuffer, &renderContext.lodRequestBuffer };
     }
 
     static glm::vec4 NormalizePlane(const glm::vec4 plane)
@@ -128,9 +366,15 @@ SceneRenderer::SceneRenderer(EventSystem& aEventSystem, const VulkanContext& aVu
 {
     using namespace SceneRendererDetails;
 
+    renderContext.sampleCount = RenderOptions::Get().GetSampleCount();
+
     CreateRenderTargets();
+    CreateFrameDataBuffers(renderContext, *vulkanContext);
+
+    renderContext.bindlessTextures = std::make_unique<BindlessTextureSet>(*vulkanContext);
 
     primitiveCullStage = std::make_unique<PrimitiveCullStage>(*vulkanContext, renderContext);
+    drawSortStage = std::make_unique<DrawSortStage>(*vulkanContext, renderContext);
     forwardStage = std::make_unique<ForwardStage>(*vulkanContext, renderContext);
 
     eventSystem->Subscribe<ES::BeforeSwapchainRecreated>(this, &SceneRenderer::OnBeforeSwapchainRecreated);
@@ -138,6 +382,7 @@ SceneRenderer::SceneRenderer(EventSystem& aEventSystem, const VulkanContext& aVu
     eventSystem->Subscribe<ES::TryReloadShaders>(this, &SceneRenderer::OnTryReloadShaders);
     eventSystem->Subscribe<ES::SceneOpened>(this, &SceneRenderer::OnSceneOpen);
     eventSystem->Subscribe<ES::SceneClosed>(this, &SceneRenderer::OnSceneClose);
+    eventSystem->Subscribe<ES::BuffersRelocated>(this, &SceneRenderer::OnBuffersRelocated);
 }
 
 SceneRenderer::~SceneRenderer()
@@ -163,8 +408,6 @@ void SceneRenderer::Process(const Frame& frame, const float deltaSeconds)
 
     renderContext.globals.view = camera.GetViewMatrix();
     renderContext.globals.projection = projection;
-    renderContext.globals.bMeshPipeline = renderOptions.GetGraphicsPipelineType() == GraphicsPipelineType::eMesh;
-    renderContext.globals.bUseLod = renderOptions.GetUseLod();
     renderContext.globals.lodTarget = glm::tan(camera.GetVerticalFov() / 2.0f) 
         * 2.0f / static_cast<float>(swapchainExtent.height); // 1px in primitive space
 
@@ -184,49 +427,202 @@ void SceneRenderer::Process(const Frame& frame, const float deltaSeconds)
         cullData.frustumTopZ = frustumTop.z;
         cullData.near = -camera.GetNear();
     }
+
+    // Culling writes to the unsorted commands which DrawSortStage then reorders into the final ones
+    const bool sortDraws = renderOptions.GetDrawSortMode() != DrawSortMode::eNone;
+    renderContext.globals.culledCommands = sortDraws
+        ? renderContext.unsortedCommandBuffer.GetDeviceAddress() : renderContext.commandBuffer.GetDeviceAddress();
 }
 
 void SceneRenderer::Render(const Frame& frame)
 {
+    ApplyReloadedShaders();
+    ApplySampleCount();
+
+    // Texture slots removed the last time this frame was current are free to reuse now
+    renderContext.bindlessTextures->BeginFrame(frame.index);
+
     if (!scene)
     {
         return;
     }
 
+    // Only releases data, the one released already is loaded back on the next scene open, see Scene::AcquireRaw
+    if (const RawSceneResidency residency = GetRawResidency(); residency != scene->GetRawResidency())
+    {
+        scene->SetRawResidency(residency);
+    }
+
+    // Ranges of primitives removed the last time this frame was current are free to reuse now
+    renderContext.geometry->BeginFrame(frame.index);
+
+    // Previous submission of the frame is complete, so its lod requests are there
+    if (lodStreamer)
+    {
+        const std::span<const std::byte> lodRequests = renderContext.lodRequestReadbackBuffers[frame.index].MapMemory();
+
+        lodStreamer->Update({ reinterpret_cast<const uint32_t*>(lodRequests.data()),
+            lodRequests.size() / sizeof(uint32_t) });
+
+        eventSystem->Fire(ES::LodStreamingUpdated{ lodStreamer->GetStats() });
+    }
+
+    // Ahead of the stage commands, so lods refined above are visible to culling of this frame
+    renderContext.geometry->RecordUploads(*frame.recorder);
+
+    // Previous submission of the frame is complete here, so its buffer can be overwritten
+    const auto frameData = std::as_bytes(std::span(&renderContext.globals, 1));
+    std::ranges::copy(frameData, renderContext.frameDataBuffers[frame.index].MapMemory().begin());
+
+    if (RenderOptions::Get().GetReuseCommands())
+    {
+        frame.recorder->Append(GetRecordedCommands(frame));
+    }
+    else
+    {
+        ExecuteStages(frame);
+    }
+}
+
+void SceneRenderer::ApplyReloadedShaders()
+{
+    bool applied = false;
+
+    for (const auto& stage : { primitiveCullStage.get(), drawSortStage.get(), forwardStage.get() })
+    {
+        applied |= stage->ApplyReloadedShaders();
+    }
+
+    if (applied)
+    {
+        ++recordingVersion;
+    }
+}
+
+void SceneRenderer::ApplySampleCount()
+{
+    const VkSampleCountFlagBits sampleCount = RenderOptions::Get().GetSampleCount();
+
+    if (sampleCount == renderContext.sampleCount)
+    {
+        return;
+    }
+
+    DestroyRenderTargets();
+
+    renderContext.sampleCount = sampleCount;
+
+    CreateRenderTargets();
+    RecreateFramebuffers();
+}
+
+RawSceneResidency SceneRenderer::GetRawResidency() const
+{
+    return lodStreamer ? RawSceneResidency::eKeepAll : RenderOptions::Get().GetRawSceneResidency();
+}
+
+void SceneRenderer::ExecuteStages(const Frame& frame) const
+{
     primitiveCullStage->Execute(frame);
+    drawSortStage->Execute(frame);
     forwardStage->Execute(frame);
 }
 
+const CommandRecorder& SceneRenderer::GetRecordedCommands(const Frame& frame)
+{
+    const RenderOptions& renderOptions = RenderOptions::Get();
+
+    // Everything else recorded commands depend on is either in the frame data or is handled by events
+    const std::tuple options = { renderOptions.GetGraphicsPipelineType(), renderOptions.GetDrawSortMode(),
+        renderOptions.GetUseLod(), renderOptions.GetDebugView() };
+
+    if (options != recordedOptions)
+    {
+        recordedOptions = options;
+        ++recordingVersion;
+    }
+
+    std::vector<RecordedFrame>& frameRecordings = recordedFrames[frame.index];
+
+    if (frame.swapchainImageIndex >= frameRecordings.size())
+    {
+        frameRecordings.resize(frame.swapchainImageIndex + 1);
+    }
+
+    RecordedFrame& recordedFrame = frameRecordings[frame.swapchainImageIndex];
+
+    // Gpu is done with all of the previous submissions of this frame, so its recordings can be reset safely
+    if (recordedFrame.version != recordingVersion)
+    {
+        if (!recordedFrame.frame.recorder)
+        {
+            recordedFrame.frame.index = frame.index;
+            recordedFrame.frame.swapchainImageIndex = frame.swapchainImageIndex;
+            recordedFrame.frame.timestampQueryPool = frame.timestampQueryPool;
+            recordedFrame.frame.recorder = std::make_unique<CommandRecorder>(
+                frame.recorder->GetInheritedStatistics(), true, *vulkanContext);
+        }
+
+        recordedFrame.frame.recorder->Reset();
+
+        ExecuteStages(recordedFrame.frame);
+
+        recordedFrame.version = recordingVersion;
+    }
+
+    return *recordedFrame.frame.recorder;
+}
+
 void SceneRenderer::CreateRenderTargets()
 {
     const Swapchain& swapchain = vulkanContext->GetSwapchain();
     const VkExtent2D swapchainExtent = swapchain.GetExtent();
 
+    // Neither target is loaded or stored by the forward pass, tilers can keep them in the tile memory only
+    const bool lazilyAllocated = vulkanContext->GetDevice().GetProperties().lazilyAllocatedMemorySupported;
+    const VkMemoryPropertyFlags memoryProperties = lazilyAllocated
+        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+        : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
     // Render targets
-    ImageDescription colorTargetDescription = {
-        .extent = { swapchainExtent.width, swapchainExtent.height, 1 },
-        .mipLevelsCount = 1,
-        .samples = vulkanContext->GetDevice().GetProperties().maxSampleCount,
-        .format = swapchain.GetSurfaceFormat().format,
-        .usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-        .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+    if (renderContext.sampleCount != VK_SAMPLE_COUNT_1_BIT)
+    {
+        ImageDescription colorTargetDescription = {
+            .extent = { swapchainExtent.width, swapchainExtent.height, 1 },
+            .mipLevelsCount = 1,
+            .samples = renderContext.sampleCount,
+            .format = swapchain.GetSurfaceFormat().format,
+            .usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+            .memoryProperties = memoryProperties };
+
+        renderContext.colorTarget = RenderTarget(colorTargetDescription, VK_IMAGE_ASPECT_COLOR_BIT, *vulkanContext);
+    }
     
     ImageDescription depthTargetDescription = {
         .extent = { swapchainExtent.width, swapchainExtent.height, 1 },
         .mipLevelsCount = 1,
-        .samples = vulkanContext->GetDevice().GetProperties().maxSampleCount,
+        .samples = renderContext.sampleCount,
         .format = VulkanConfig::depthImageFormat,
-        .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+        .usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        .memoryProperties = memoryProperties };
     
-    renderContext.colorTarget = RenderTarget(colorTargetDescription, VK_IMAGE_ASPECT_COLOR_BIT, *vulkanContext);
     renderContext.depthTarget = RenderTarget(depthTargetDescription, VK_IMAGE_ASPECT_DEPTH_BIT, *vulkanContext);
 }
 
 void SceneRenderer::DestroyRenderTargets()
 {
-    renderContext.colorTarget = {};
-    renderContext.depthTarget = {};
+    DeletionQueue& deletionQueue = vulkanContext->GetDeletionQueue();
+
+    deletionQueue.Enqueue(std::move(renderContext.colorTarget));
+    deletionQueue.Enqueue(std::move(renderContext.depthTarget));
+}
+
+void SceneRenderer::RecreateFramebuffers()
+{
+    primitiveCullStage->RecreateFramebuffers();
+    forwardStage->RecreateFramebuffers();
+
+    ++recordingVersion;
 }
 
 void SceneRenderer::OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecreated& event)
@@ -237,15 +633,15 @@ void SceneRenderer::OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecreate
 void SceneRenderer::OnSwapchainRecreated(const ES::SwapchainRecreated& event)
 {
     CreateRenderTargets();
-
-    primitiveCullStage->RecreateFramebuffers();
-    forwardStage->RecreateFramebuffers();
+    RecreateFramebuffers();
 }
 
 void SceneRenderer::OnTryReloadShaders(const ES::TryReloadShaders& event)
 {
-    primitiveCullStage->TryReloadShaders();
-    forwardStage->TryReloadShaders();
+    // Pipelines are rebuilt in background and swapped in by ApplyReloadedShaders
+    primitiveCullStage->TryReloadShaders(event.changedFiles);
+    drawSortStage->TryReloadShaders(event.changedFiles);
+    forwardStage->TryReloadShaders(event.changedFiles);
 }
 
 void SceneRenderer::OnSceneOpen(const ES::SceneOpened& event)
@@ -254,67 +650,112 @@ void SceneRenderer::OnSceneOpen(const ES::SceneOpened& event)
 
     scene = &event.scene;
 
-    if (vulkanContext->GetDevice().GetProperties().meshShadersSupported)
-    {
-        SceneHelpers::GenerateMeshlets(scene->GetRaw());
-    }
+    const RawScene& rawScene = scene->AcquireRaw();
 
-    SceneRendererDetails::CreateSceneBuffers(scene->GetRaw(), renderContext, *vulkanContext);
+    const std::vector<uint32_t> slots = SceneRendererDetails::CreateSceneBuffers(rawScene, renderContext,
+        *vulkanContext);
     SceneRendererDetails::CreateIndirectBuffers(renderContext, *vulkanContext);
+    SceneRendererDetails::CreateLodRequestBuffers(renderContext, *vulkanContext);
 
-    vulkanContext->GetDevice().ExecuteOneTimeCommandBuffer([&](const VkCommandBuffer cmd) {
-        CopyBufferToBuffer(cmd, renderContext.vertexBuffer.GetStagingBuffer(), renderContext.vertexBuffer);
-        CopyBufferToBuffer(cmd, renderContext.indexBuffer.GetStagingBuffer(), renderContext.indexBuffer);
+    lodStreamer = std::make_unique<LodStreamer>(rawScene, slots, *renderContext.geometry);
 
-        if (renderContext.meshletDataBuffer.IsValid())
-        {
-            CopyBufferToBuffer(cmd, renderContext.meshletDataBuffer.GetStagingBuffer(), renderContext.meshletDataBuffer);
-            CopyBufferToBuffer(cmd, renderContext.meshletBuffer.GetStagingBuffer(), renderContext.meshletBuffer);
-        }
+    if (!lodStreamer->IsStreaming())
+    {
+        lodStreamer.reset();
+    }
+
+    renderContext.lodStreaming = lodStreamer != nullptr;
 
-        CopyBufferToBuffer(cmd, renderContext.primitiveBuffer.GetStagingBuffer(), renderContext.primitiveBuffer);
+    // Scene geometry uploads itself, see SceneGeometry::AddPrimitives
+    vulkanContext->GetDevice().ExecuteOneTimeCommandBuffer([&](const VkCommandBuffer cmd) {
         CopyBufferToBuffer(cmd, renderContext.drawBuffer.GetStagingBuffer(), renderContext.drawBuffer);
         CopyBufferToBuffer(cmd, renderContext.commandCountBuffer.GetStagingBuffer(), renderContext.commandCountBuffer);
 
         SynchronizationUtils::SetMemoryBarrier(cmd, Barriers::transferWriteToComputeRead);
     });
 
-    renderContext.vertexBuffer.DestroyStagingBuffer();
-    renderContext.indexBuffer.DestroyStagingBuffer();
+    renderContext.drawBuffer.DestroyStagingBuffer();
+    renderContext.commandCountBuffer.DestroyStagingBuffer();
+
+    SceneRendererDetails::SetBufferAddresses(renderContext);
 
-    if (renderContext.meshletDataBuffer.IsValid())
+    // Scene has a single texture so far, removed from the array in OnSceneClose
+    if (const Texture& texture = scene->GetTexture(); texture.IsValid())
     {
-        renderContext.meshletDataBuffer.DestroyStagingBuffer();
-        renderContext.meshletBuffer.DestroyStagingBuffer();
+        renderContext.bindlessTextures->Add(texture);
     }
 
-    renderContext.primitiveBuffer.DestroyStagingBuffer();
-    renderContext.drawBuffer.DestroyStagingBuffer();
-    renderContext.commandCountBuffer.DestroyStagingBuffer();
+    // Everything is on gpu now, CPU copies are kept only as much as the residency policy says
+    scene->SetRawResidency(GetRawResidency());
+
+    for (Buffer* buffer : SceneRendererDetails::GetRelocatableBuffers(renderContext))
+    {
+        vulkanContext->GetMemoryManager().RegisterRelocatable(*buffer);
+    }
+
+    // Past the budget the driver starts paging or fails allocations, better to know it from the log
+    if (const float budgetUsage = vulkanContext->GetMemoryManager().GetDeviceLocalBudgetUsage(); budgetUsage > 0.9f)
+    {
+        LogW << "Scene uses " << budgetUsage * 100.0f << "% of device local memory budget\n";
+    }
     
     primitiveCullStage->Prepare(*scene);
+    drawSortStage->Prepare(*scene);
     forwardStage->Prepare(*scene);
+
+    ++recordingVersion;
 }
 
 void SceneRenderer::OnSceneClose(const ES::SceneClosed& event)
 {
-    vulkanContext->GetDevice().WaitIdle();
+    // Frames in flight might still use scene buffers, so let the deletion queue handle them instead of waiting
+    DeletionQueue& deletionQueue = vulkanContext->GetDeletionQueue();
 
-    renderContext.vertexBuffer = {};
-    renderContext.indexBuffer = {};
+    for (const Buffer* buffer : SceneRendererDetails::GetRelocatableBuffers(renderContext))
+    {
+        vulkanContext->GetMemoryManager().UnregisterRelocatable(*buffer);
+    }
 
-    if (renderContext.meshletDataBuffer.IsValid())
+    if (lodStreamer)
     {
-        renderContext.meshletDataBuffer = {};
-        renderContext.meshletBuffer = {};
+        lodStreamer.reset();
+        eventSystem->Fire(ES::LodStreamingUpdated{});
     }
 
-    renderContext.primitiveBuffer = {};
-    renderContext.drawBuffer = {};
-    renderContext.commandCountBuffer = {};
-    renderContext.commandBuffer = {};
+    renderContext.lodStreaming = false;
+
+    renderContext.geometry.reset(); // Enqueues its arenas the same way
+    deletionQueue.Enqueue(std::move(renderContext.drawBuffer));
+    deletionQueue.Enqueue(std::move(renderContext.commandCountBuffer));
+    deletionQueue.Enqueue(std::move(renderContext.commandBuffer));
+    deletionQueue.Enqueue(std::move(renderContext.unsortedCommandBuffer));
+    deletionQueue.Enqueue(std::move(renderContext.sortKeyBuffer));
+    deletionQueue.Enqueue(std::move(renderContext.lodRequestBuffer));
+
+    for (Buffer& readbackBuffer : renderContext.lodRequestReadbackBuffers)
+    {
+        deletionQueue.Enqueue(std::move(readbackBuffer));
+    }
 
     vulkanContext->GetDescriptorSetsManager().ResetDescriptors(DescriptorScope::eSceneRenderer);
+    renderContext.bindlessTextures->Reset();
     
     scene = nullptr;
 }
+
+void SceneRenderer::OnBuffersRelocated(const ES::BuffersRelocated& event)
+{
+    if (!scene)
+    {
+        return;
+    }
+
+    SceneRendererDetails::SetBufferAddresses(renderContext);
+
+    primitiveCullStage->OnBuffersRelocated();
+    drawSortStage->OnBuffersRelocated();
+    forwardStage->OnBuffersRelocated();
+
+    // Recorded commands bind the old buffers
+    ++recordingVersion;
+}
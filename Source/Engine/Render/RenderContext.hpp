@@ -2,28 +2,56 @@
 
 #include "Shaders/Common.h"
 #include "Utils/Constants.hpp"
+#include "Engine/Render/SceneGeometry.hpp"
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
 #include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/BindlessTextureSet.hpp"
 #include "Engine/Render/Vulkan/Image/RenderTarget.hpp"
 
+// Range of the command buffer filled by culling and drawn by a single indirect call
+struct CommandBatch
+{
+    uint32_t countIndex = 0;
+    uint32_t offset = 0;
+    uint32_t maxCount = 0; // Actual command count is only known on GPU
+};
+
 struct RenderContext
 {
+    // Color target is created only with multisampling, otherwise scene is rendered to the swapchain image directly
     RenderTarget colorTarget;
     RenderTarget depthTarget;
+    VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
 
-    gpu::PushConstants globals = { .view = Matrix4::identity, .projection = Matrix4::identity };
+    gpu::FrameData globals = { .view = Matrix4::identity, .projection = Matrix4::identity };
 
-    // Vertex pipeline
-    Buffer vertexBuffer;
-    Buffer indexBuffer;
+    // Globals are copied to the buffer of the current frame, all scene pipelines bind it as set 1
+    std::array<Buffer, VulkanConfig::maxFramesInFlight> frameDataBuffers;
+    std::array<VkDescriptorSet, VulkanConfig::maxFramesInFlight> frameDataDescriptorSets = {};
+    DescriptorSetLayout frameDataDescriptorSetLayout;
 
-    // Mesh pipeline
-    Buffer meshletDataBuffer;
-    Buffer meshletBuffer;
+    // Scene pipelines bind it as set 0, scene buffers themselves are accessed via device addresses in globals
+    std::unique_ptr<BindlessTextureSet> bindlessTextures;
 
-    Buffer primitiveBuffer;
+    // Vertices, indices, meshlets and primitives of resident scene primitives
+    std::unique_ptr<SceneGeometry> geometry;
 
     Buffer drawBuffer;
 
+    // Vertex pipeline commands of 32-bit and 16-bit index lods, globals.shortCommandsOffset is the second offset
+    std::array<CommandBatch, 2> vertexCommandBatches = {};
+
     Buffer commandCountBuffer;
     Buffer commandBuffer; // Either indirect commands or task commands, see PrimitiveCull.comp & PrimitiveCullStage
+
+    // Culling writes here instead of commandBuffer if draws are sorted, see DrawSortStage
+    Buffer unsortedCommandBuffer;
+    Buffer sortKeyBuffer;
+
+    // Written by culling, copied to the readback buffer of the frame for LodStreamer.
+    // Without streaming (all lods are resident) culling skips them entirely
+    Buffer lodRequestBuffer;
+    std::array<Buffer, VulkanConfig::maxFramesInFlight> lodRequestReadbackBuffers;
+    bool lodStreaming = false;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Scene/SceneDataStructures.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 
 class EventSystem;
@@ -21,11 +22,35 @@ enum class GraphicsPipelineType
     eVertex,
 };
 
+// Sorting of the culled commands, state is just a primitive for now (material later)
+enum class DrawSortMode
+{
+    eNone = 0,
+    eDepth,
+    eState,
+    eStateDepth,
+};
+
+// Replaces shading with debug colors, selects the specialized pipeline permutations
+enum class DebugView
+{
+    eNone = 0,
+    eMeshlets,
+    eLods,
+};
+
 namespace OptionValues
 {
     // Other code might need these to iterate through
     inline constexpr std::array rendererTypes = { RendererType::eScene, RendererType::eCompute };
     inline constexpr std::array graphicsPipelineTypes = { GraphicsPipelineType::eMesh, GraphicsPipelineType::eVertex };
+    inline constexpr std::array drawSortModes = { DrawSortMode::eNone, DrawSortMode::eDepth, DrawSortMode::eState,
+        DrawSortMode::eStateDepth };
+    inline constexpr std::array debugViews = { DebugView::eNone, DebugView::eMeshlets, DebugView::eLods };
+    inline constexpr std::array sampleCounts = { VK_SAMPLE_COUNT_1_BIT, VK_SAMPLE_COUNT_2_BIT, VK_SAMPLE_COUNT_4_BIT,
+        VK_SAMPLE_COUNT_8_BIT };
+    inline constexpr std::array rawSceneResidencies = { RawSceneResidency::eKeepAll, RawSceneResidency::eKeepMetadata,
+        RawSceneResidency::eReload };
 }
 
 class RenderOptions
@@ -47,6 +72,8 @@ public:
 
     // Support functions
     bool IsGraphicsPipelineTypeSupported(GraphicsPipelineType graphicsPipelineType) const;
+    bool IsShaderOptimizationSupported() const;
+    bool IsSampleCountSupported(VkSampleCountFlagBits sampleCount) const;
     
     // Getters and setters
     RendererType GetRendererType() const;
@@ -60,6 +87,28 @@ public:
 
     bool GetFreezeCamera() const;
     void SetFreezeCamera(bool freezeCamera);
+
+    DrawSortMode GetDrawSortMode() const;
+    void SetDrawSortMode(DrawSortMode drawSortMode);
+
+    DebugView GetDebugView() const;
+    void SetDebugView(DebugView debugView);
+
+    // MSAA of the scene render targets, 1 renders straight to the swapchain image
+    VkSampleCountFlagBits GetSampleCount() const;
+    void SetSampleCount(VkSampleCountFlagBits sampleCount);
+
+    // CPU scene data kept after the upload. Open scene releases data on the next frame, keeping more needs a reopen
+    RawSceneResidency GetRawSceneResidency() const;
+    void SetRawSceneResidency(RawSceneResidency rawSceneResidency);
+
+    // Scene commands are recorded once per frame in flight and swapchain image and then just resubmitted
+    bool GetReuseCommands() const;
+    void SetReuseCommands(bool reuseCommands);
+
+    // Changing it recompiles all of the shaders from sources, allows comparing optimized and unoptimized spirv
+    bool GetOptimizeShaders() const;
+    void SetOptimizeShaders(bool optimizeShaders);
     
 private:
     void OnKeyInput(const ES::KeyInput& event);
@@ -72,4 +121,10 @@ private:
     GraphicsPipelineType graphicsPipelineType = GraphicsPipelineType::eVertex;
     bool useLod = true;
     bool freezeCamera = false;
+    DrawSortMode drawSortMode = DrawSortMode::eNone;
+    DebugView debugView = DebugView::eNone;
+    VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    RawSceneResidency rawSceneResidency = RawSceneResidency::eKeepMetadata;
+    bool reuseCommands = false;
+    bool optimizeShaders = true;
 };
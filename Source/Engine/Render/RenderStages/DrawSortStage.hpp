@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Engine/Render/RenderStages/RenderStage.hpp"
+#include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorUpdateTemplate.hpp"
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
+
+// Reorders culled commands by depth and/or state with a GPU LSD radix sort, see RenderOptions::GetDrawSortMode
+class DrawSortStage : public RenderStage
+{
+public:
+    DrawSortStage(const VulkanContext& vulkanContext, RenderContext& renderContext);
+    ~DrawSortStage() override;
+
+    void Prepare(const Scene& scene) override;
+
+    void Execute(const Frame& frame) override;
+
+    void TryReloadShaders(std::span<const std::string> changedFiles) override;
+    bool ApplyReloadedShaders() override;
+
+    void OnBuffersRelocated() override;
+
+private:
+    enum class SortPass
+    {
+        eHistogram,
+        eScan,
+        eScatter,
+        eReorder,
+        eCount
+    };
+
+    using PassMask = std::array<bool, static_cast<size_t>(SortPass::eCount)>;
+
+    using DescriptorSets = std::array<VkDescriptorSet, 2>;
+
+    // Sets bind relocatable scene buffers by handle. Every frame in flight owns its sets, so they are rewritten
+    // in place on the next execution of the frame after a relocation, see OnBuffersRelocated
+    void CreateDescriptorSets();
+    void UpdateDescriptorSets(uint32_t frameIndex);
+
+    // Masked passes are compiled concurrently, pipelines are keyed by SortPass.
+    // Static, so reload builds only use what they were given, see PipelineReloader::Start
+    static PipelineReloader::KeyedPipelines CreatePipelines(VkDescriptorSetLayout layout, const PassMask& passes,
+        const VulkanContext& vulkanContext);
+    static Pipeline CreatePipeline(ShaderModule&& shaderModule, VkDescriptorSetLayout layout,
+        const VulkanContext& vulkanContext);
+
+    // Keys and values ping-pong between A (sortKeyBuffer + valueBuffer) and B (scratch buffers)
+    Buffer valueBuffer;
+    Buffer scratchKeyBuffer;
+    Buffer scratchValueBuffer;
+    Buffer histogramBuffer;
+
+    DescriptorSetLayout descriptorSetLayout;
+    DescriptorUpdateTemplate descriptorUpdateTemplate;
+    std::array<DescriptorSets, VulkanConfig::maxFramesInFlight> descriptorSets = {};
+    std::array<bool, VulkanConfig::maxFramesInFlight> outdatedDescriptorSets = {};
+    std::array<Pipeline, static_cast<size_t>(SortPass::eCount)> pipelines;
+
+    PipelineReloader pipelineReloader;
+};
\ No newline at end of file
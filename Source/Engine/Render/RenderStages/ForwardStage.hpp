@@ -4,6 +4,7 @@
 #include "Engine/Render/Vulkan/RenderPass.hpp"
 #include "Engine/Render/RenderStages/RenderStage.hpp"
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
 
 class ForwardStage : public RenderStage
 {
@@ -16,18 +17,50 @@ public:
     void Execute(const Frame& frame) override;
     
     void RecreateFramebuffers() override;
-    void TryReloadShaders() override;
+    void TryReloadShaders(std::span<const std::string> changedFiles) override;
+    bool ApplyReloadedShaders() override;
     
 private:
-    Pipeline CreateMeshPipeline();
-    Pipeline CreateVertexPipeline();
+    // Render pass and layouts are snapshots, so a reload build never reads members the main thread replaces
+    struct PipelineDescription
+    {
+        GraphicsPipelineType type;
+        DebugView debugView;
+        VkSampleCountFlagBits sampleCount;
+        VkRenderPass renderPass;
+        std::vector<VkDescriptorSetLayout> layouts;
+    };
+
+    // Supported pipeline types in OptionValues::graphicsPipelineTypes order
+    std::vector<PipelineDescription> GetPipelineDescriptions(DebugView debugView) const;
+    PipelineDescription GetPipelineDescription(GraphicsPipelineType type, DebugView debugView) const;
+
+    // Pipeline of the current render pass sample count
+    const Pipeline& GetPipeline(GraphicsPipelineType type, DebugView debugView);
+
+    // Starts compilation of all pipelines shaders at once, each pipeline then waits only for its own modules.
+    // Pipelines are keyed by permutation, see ForwardStageDetails::GetPermutation.
+    // Static, so reload builds get everything they need from the descriptions, see PipelineReloader::Start
+    static PipelineReloader::KeyedPipelines CreatePipelines(const std::vector<PipelineDescription>& descriptions,
+        const VulkanContext& vulkanContext);
+
+    static Pipeline CreateMeshPipeline(std::vector<ShaderModule>&& shaderModules,
+        const PipelineDescription& description, const VulkanContext& vulkanContext);
+    static Pipeline CreateVertexPipeline(std::vector<ShaderModule>&& shaderModules,
+        const PipelineDescription& description, const VulkanContext& vulkanContext);
     
-    void ExecuteMesh(const Frame& frame) const;
-    void ExecuteVertex(const Frame& frame) const;
+    void ExecuteMesh(VkCommandBuffer commandBuffer) const;
+    void ExecuteVertex(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
     
     RenderPass renderPass;
+    VkSampleCountFlagBits renderPassSampleCount = VK_SAMPLE_COUNT_1_BIT; // Lags behind RenderContext until recreation
+
+    // Replaced while reload builds could still use them, released once the reloader is idle
+    std::vector<RenderPass> retiredRenderPasses;
     std::vector<VkFramebuffer> framebuffers;
     
-    std::unordered_map<GraphicsPipelineType, std::pair<VkDescriptorSet, DescriptorSetLayout>> descriptors;
-    std::unordered_map<GraphicsPipelineType, Pipeline> graphicsPipelines;
+    // Permutations are created on first use
+    std::unordered_map<uint32_t, Pipeline> graphicsPipelines;
+
+    PipelineReloader pipelineReloader;
 };
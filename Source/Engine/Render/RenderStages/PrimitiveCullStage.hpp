@@ -2,7 +2,7 @@
 
 #include "Engine/Render/RenderStages/RenderStage.hpp"
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
-#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
 
 class PrimitiveCullStage : public RenderStage
 {
@@ -14,12 +14,21 @@ public:
 
     void Execute(const Frame& frame) override;
 
-    void TryReloadShaders() override;
+    void TryReloadShaders(std::span<const std::string> changedFiles) override;
+    bool ApplyReloadedShaders() override;
 
 private:
-    Pipeline CreatePipeline() const;
+    const Pipeline& GetPipeline(uint32_t permutation);
 
-    DescriptorSetLayout descriptorSetLayout;
-    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
-    Pipeline pipeline;
+    // Shader is compiled once, permutations only differ in specialization constants.
+    // Static, so reload builds only use what they were given, see PipelineReloader::Start
+    static PipelineReloader::KeyedPipelines CreatePipelines(std::span<const uint32_t> permutations,
+        const std::vector<VkDescriptorSetLayout>& layouts, const VulkanContext& vulkanContext);
+    static Pipeline CreatePipeline(const ShaderModule& shaderModule, uint32_t permutation,
+        const std::vector<VkDescriptorSetLayout>& layouts, const VulkanContext& vulkanContext);
+
+    // Keyed by shader feature bits, see PrimitiveCullStageDetails::GetPermutation
+    std::unordered_map<uint32_t, Pipeline> pipelines;
+
+    PipelineReloader pipelineReloader;
 };
@@ -0,0 +1,355 @@
+#include "Engine/Render/RenderStages/DrawSortStage.hpp"
+
+#include "Shaders/Common.h"
+#include "Engine/Render/RenderOptions.hpp"
+#include "Engine/Render/Vulkan/Pipelines/ComputePipelineBuilder.hpp"
+#include "Engine/Render/Vulkan/Synchronization/SynchronizationUtils.hpp"
+
+namespace DrawSortStageDetails
+{
+    static constexpr std::array<std::string_view, 4> shaderPaths = {
+        "~/Shaders/Sorting/RadixHistogram.comp",
+        "~/Shaders/Sorting/RadixScan.comp",
+        "~/Shaders/Sorting/RadixScatter.comp",
+        "~/Shaders/Sorting/CommandReorder.comp" };
+
+    static constexpr VkDeviceSize sortBufferSize = gpu::primitiveCullMaxCommands * sizeof(uint32_t);
+    static constexpr VkDeviceSize histogramBufferSize = 
+        gpu::radixSortMaxBlocks * gpu::radixSortBinCount * sizeof(uint32_t);
+
+    static constexpr uint32_t keyBits = 32;
+
+    static Buffer CreateStorageBuffer(VkDeviceSize size, const VulkanContext& vulkanContext)
+    {
+        const BufferDescription bufferDescription = {
+            .size = size,
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            .memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .category = MemoryCategory::eCommands };
+
+        return Buffer(bufferDescription, false, vulkanContext);
+    }
+
+    static std::tuple<VkDescriptorSet, DescriptorSetLayout> CreateDescriptors(const RenderContext& renderContext,
+        const Buffer& srcKeys, const Buffer& srcValues, const Buffer& dstKeys, const Buffer& dstValues,
+        const Buffer& histograms, const VulkanContext& vulkanContext)
+    {
+        return vulkanContext.GetDescriptorSetsManager().GetDescriptorSetBuilder(DescriptorScope::eSceneRenderer)
+            .Bind(0, renderContext.commandCountBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(1, srcKeys, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(2, srcValues, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(3, dstKeys, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(4, dstValues, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(5, histograms, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(6, renderContext.unsortedCommandBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 
+                VK_SHADER_STAGE_COMPUTE_BIT)
+            .Bind(7, renderContext.commandBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Build();
+    }
+
+    // Same bindings as CreateDescriptors, in binding order
+    static std::array<DescriptorData, 8> GetDescriptorData(const RenderContext& renderContext,
+        const Buffer& srcKeys, const Buffer& srcValues, const Buffer& dstKeys, const Buffer& dstValues,
+        const Buffer& histograms)
+    {
+        return {
+            DescriptorData::FromBuffer(renderContext.commandCountBuffer),
+            DescriptorData::FromBuffer(srcKeys),
+            DescriptorData::FromBuffer(srcValues),
+            DescriptorData::FromBuffer(dstKeys),
+            DescriptorData::FromBuffer(dstValues),
+            DescriptorData::FromBuffer(histograms),
+            DescriptorData::FromBuffer(renderContext.unsortedCommandBuffer),
+            DescriptorData::FromBuffer(renderContext.commandBuffer) };
+    }
+
+    // Key layout is [state][depth:depthBits], so every mode is just a range of 4 bit digits
+    static std::pair<uint32_t, uint32_t> GetShiftRange(DrawSortMode mode, uint32_t depthBits)
+    {
+        switch (mode)
+        {
+        case DrawSortMode::eDepth:
+            return { 0, depthBits };
+        case DrawSortMode::eState:
+            return { depthBits, keyBits };
+        case DrawSortMode::eStateDepth:
+            return { 0, keyBits };
+        default:
+            Assert(false);
+            return {};
+        }
+    }
+
+    static uint32_t GetGroupCount(uint32_t elementCount, uint32_t groupSize)
+    {
+        return (elementCount + groupSize - 1) / groupSize;
+    }
+
+    // Batches are sorted independently, shaders early out past the actual command count.
+    // Vertex pipeline commands are split by index type, see PrimitiveCull.comp
+    static std::span<const CommandBatch> GetSortBatches(const bool meshPipeline, const RenderContext& renderContext)
+    {
+        static constexpr CommandBatch meshBatch = { gpu::commandCountIndex, 0, gpu::primitiveCullMaxCommands };
+
+        return meshPipeline ? std::span(&meshBatch, 1) : std::span(renderContext.vertexCommandBatches);
+    }
+}
+
+DrawSortStage::DrawSortStage(const VulkanContext& aVulkanContext, RenderContext& aRenderContext)
+    : RenderStage{ aVulkanContext, aRenderContext }
+    , pipelineReloader{ aVulkanContext }
+{
+    using namespace DrawSortStageDetails;
+
+    valueBuffer = CreateStorageBuffer(sortBufferSize, *vulkanContext);
+    scratchKeyBuffer = CreateStorageBuffer(sortBufferSize, *vulkanContext);
+    scratchValueBuffer = CreateStorageBuffer(sortBufferSize, *vulkanContext);
+    histogramBuffer = CreateStorageBuffer(histogramBufferSize, *vulkanContext);
+}
+
+DrawSortStage::~DrawSortStage() = default;
+
+void DrawSortStage::Prepare(const Scene& scene)
+{
+    CreateDescriptorSets();
+
+    if (std::ranges::all_of(pipelines, &Pipeline::IsValid))
+    {
+        return;
+    }
+
+    constexpr PassMask allPasses = { true, true, true, true };
+
+    for (auto& [pass, pipeline] : CreatePipelines(descriptorSetLayout, allPasses, *vulkanContext))
+    {
+        Assert(pipeline.IsValid());
+        pipelines[pass] = std::move(pipeline);
+    }
+}
+
+void DrawSortStage::Execute(const Frame& frame)
+{
+    using namespace DrawSortStageDetails;
+
+    const DrawSortMode sortMode = RenderOptions::Get().GetDrawSortMode();
+
+    if (sortMode == DrawSortMode::eNone)
+    {
+        return;
+    }
+
+    const bool meshPipeline = RenderOptions::Get().GetGraphicsPipelineType() == GraphicsPipelineType::eMesh;
+
+    const std::span<const CommandBatch> batches = GetSortBatches(meshPipeline, *renderContext);
+
+    // Gpu is done with the previous execution of the frame, so its sets can be rewritten
+    if (outdatedDescriptorSets[frame.index])
+    {
+        UpdateDescriptorSets(frame.index);
+    }
+
+    const DescriptorSets frameDescriptorSets = descriptorSets[frame.index];
+
+    frame.recorder->RecordSecondary([=, this, &frame](VkCommandBuffer cmd) {
+        using namespace SynchronizationUtils;
+
+        GpuTimers::Begin(cmd, frame.timestampQueryPool, frame.index, GpuTimer::eSort);
+
+        constexpr PipelineBarrier computeBarrier = {
+            .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+
+        const auto dispatch = [&](SortPass pass, VkDescriptorSet descriptorSet, 
+            const gpu::RadixSortPushConstants& pushConstants, uint32_t groupCount) {
+            const Pipeline& pipeline = pipelines[static_cast<size_t>(pass)];
+
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+            vkCmdPushConstants(cmd, pipeline.GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                static_cast<uint32_t>(sizeof(gpu::RadixSortPushConstants)), &pushConstants);
+
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.GetLayout(),
+                0, 1, &descriptorSet, 0, nullptr);
+
+            vkCmdDispatch(cmd, groupCount, 1, 1);
+
+            SetMemoryBarrier(cmd, computeBarrier);
+        };
+
+        const auto [firstShift, lastShift] = GetShiftRange(sortMode, renderContext->globals.sortDepthBits);
+
+        // Batches only share the histogram buffer, barriers in between keep them apart
+        for (const CommandBatch& batch : batches)
+        {
+            if (batch.maxCount == 0)
+            {
+                continue;
+            }
+
+            const uint32_t blockCount = GetGroupCount(batch.maxCount, gpu::radixSortBlockSize);
+
+            // Pass count is always even so sorted values end up in valueBuffer again
+            uint32_t passIndex = 0;
+            for (uint32_t shift = firstShift; shift < lastShift; shift += gpu::radixSortDigitBits, ++passIndex)
+            {
+                const VkDescriptorSet descriptorSet = frameDescriptorSets[passIndex % 2];
+
+                const gpu::RadixSortPushConstants pushConstants = {
+                    .shift = shift,
+                    .bFirstPass = passIndex == 0 ? 1u : 0u,
+                    .bMeshPipeline = meshPipeline ? 1u : 0u,
+                    .countIndex = batch.countIndex,
+                    .elementOffset = batch.offset,
+                    .maxElementCount = batch.maxCount };
+
+                dispatch(SortPass::eHistogram, descriptorSet, pushConstants, blockCount);
+                dispatch(SortPass::eScan, descriptorSet, pushConstants, 1);
+                dispatch(SortPass::eScatter, descriptorSet, pushConstants, blockCount);
+            }
+
+            Assert(passIndex % 2 == 0);
+
+            const gpu::RadixSortPushConstants reorderPushConstants = {
+                .bMeshPipeline = meshPipeline ? 1u : 0u,
+                .countIndex = batch.countIndex,
+                .elementOffset = batch.offset,
+                .maxElementCount = batch.maxCount };
+
+            dispatch(SortPass::eReorder, frameDescriptorSets[0], reorderPushConstants, 
+                GetGroupCount(batch.maxCount, gpu::radixSortWgSize));
+        }
+
+        constexpr PipelineBarrier afterSortBarrier = {
+            .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT };
+
+        SetMemoryBarrier(cmd, afterSortBarrier);
+
+        GpuTimers::End(cmd, frame.timestampQueryPool, frame.index, GpuTimer::eSort);
+    });
+}
+
+void DrawSortStage::TryReloadShaders(const std::span<const std::string> changedFiles)
+{
+    using namespace DrawSortStageDetails;
+
+    const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
+
+    const auto isAffected = [&](const std::string_view shaderPath) {
+        return shaderManager.IsShaderAffected(FilePath(shaderPath), changedFiles);
+    };
+
+    // Layout is only known after Prepare, pipelines will be created there with the latest shaders anyway
+    if (!std::ranges::all_of(pipelines, &Pipeline::IsValid) || !std::ranges::any_of(shaderPaths, isAffected))
+    {
+        return;
+    }
+
+    PassMask affectedPasses = {};
+    std::ranges::transform(shaderPaths, affectedPasses.begin(), isAffected);
+
+    pipelineReloader.Start([&context = *vulkanContext, layout = static_cast<VkDescriptorSetLayout>(descriptorSetLayout),
+        affectedPasses]() {
+        return CreatePipelines(layout, affectedPasses, context);
+    });
+}
+
+bool DrawSortStage::ApplyReloadedShaders()
+{
+    return pipelineReloader.TryApply(pipelines);
+}
+
+void DrawSortStage::OnBuffersRelocated()
+{
+    // Frames in flight keep binding the old buffers through their sets until they finish,
+    // old buffers live until the defragmentation pass ends
+    outdatedDescriptorSets.fill(true);
+}
+
+void DrawSortStage::CreateDescriptorSets()
+{
+    using namespace DrawSortStageDetails;
+
+    for (DescriptorSets& frameDescriptorSets : descriptorSets)
+    {
+        std::tie(frameDescriptorSets[0], descriptorSetLayout) = CreateDescriptors(*renderContext, 
+            renderContext->sortKeyBuffer, valueBuffer, scratchKeyBuffer, scratchValueBuffer, histogramBuffer, 
+            *vulkanContext);
+        std::tie(frameDescriptorSets[1], std::ignore) = CreateDescriptors(*renderContext, 
+            scratchKeyBuffer, scratchValueBuffer, renderContext->sortKeyBuffer, valueBuffer, histogramBuffer, 
+            *vulkanContext);
+    }
+
+    if (!descriptorUpdateTemplate.IsValid())
+    {
+        descriptorUpdateTemplate = DescriptorUpdateTemplate(descriptorSetLayout, *vulkanContext);
+    }
+
+    outdatedDescriptorSets.fill(false);
+}
+
+void DrawSortStage::UpdateDescriptorSets(const uint32_t frameIndex)
+{
+    using namespace DrawSortStageDetails;
+
+    const auto& [setA, setB] = descriptorSets[frameIndex];
+
+    descriptorUpdateTemplate.Update(setA, GetDescriptorData(*renderContext, 
+        renderContext->sortKeyBuffer, valueBuffer, scratchKeyBuffer, scratchValueBuffer, histogramBuffer));
+    descriptorUpdateTemplate.Update(setB, GetDescriptorData(*renderContext, 
+        scratchKeyBuffer, scratchValueBuffer, renderContext->sortKeyBuffer, valueBuffer, histogramBuffer));
+
+    outdatedDescriptorSets[frameIndex] = false;
+}
+
+PipelineReloader::KeyedPipelines DrawSortStage::CreatePipelines(const VkDescriptorSetLayout layout,
+    const PassMask& passes, const VulkanContext& vulkanContext)
+{
+    using namespace DrawSortStageDetails;
+
+    const ShaderManager& shaderManager = vulkanContext.GetShaderManager();
+
+    std::array<std::future<ShaderModule>, static_cast<size_t>(SortPass::eCount)> shaderModules;
+
+    for (size_t i = 0; i < shaderModules.size(); ++i)
+    {
+        if (passes[i])
+        {
+            shaderModules[i] = shaderManager.CreateShaderModuleAsync(FilePath(shaderPaths[i]), ShaderType::eCompute);
+        }
+    }
+
+    PipelineReloader::KeyedPipelines newPipelines;
+
+    for (size_t i = 0; i < shaderModules.size(); ++i)
+    {
+        if (shaderModules[i].valid())
+        {
+            newPipelines.emplace_back(static_cast<uint32_t>(i),
+                CreatePipeline(shaderModules[i].get(), layout, vulkanContext));
+        }
+    }
+
+    return newPipelines;
+}
+
+Pipeline DrawSortStage::CreatePipeline(ShaderModule&& shaderModule, const VkDescriptorSetLayout layout,
+    const VulkanContext& vulkanContext)
+{
+    if (!shaderModule.IsValid())
+    {
+        return {};
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts = { layout };
+
+    return ComputePipelineBuilder(vulkanContext)
+        .SetDescriptorSetLayouts(std::move(layouts))
+        .AddPushConstantRange({ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(gpu::RadixSortPushConstants) })
+        .SetShaderModule(std::move(shaderModule))
+        .Build();
+}
\ No newline at end of file
@@ -11,12 +11,15 @@ namespace ForwardStageDetails
     static constexpr std::string_view meshShaderPath = "~/Shaders/Meshlet.mesh";
     static constexpr std::string_view fragmentShaderPath = "~/Shaders/Default.frag";
 
-    static RenderPass CreateRenderPass(const VulkanContext& vulkanContext)
+    static RenderPass CreateRenderPass(const VulkanContext& vulkanContext, const VkSampleCountFlagBits sampleCount)
     {
+        const bool multisampled = sampleCount != VK_SAMPLE_COUNT_1_BIT;
+
+        // Samples are resolved inside the pass and never leave the tile memory on tilers, see CreateRenderTargets
         AttachmentDescription colorAttachmentDescription = {
             .format = vulkanContext.GetSwapchain().GetSurfaceFormat().format,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE,
             .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
             .actualLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
             .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
@@ -29,6 +32,7 @@ namespace ForwardStageDetails
             .actualLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
             .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
 
+        // Nothing reads depth after the pass, so it's discarded instead of being resolved or stored
         AttachmentDescription depthStencilAttachmentDescription = {
             .format = VulkanConfig::depthImageFormat,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
@@ -58,10 +62,21 @@ namespace ForwardStageDetails
             .dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
             .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT } };
 
-        return RenderPassBuilder(vulkanContext)
-            .SetBindPoint(VK_PIPELINE_BIND_POINT_GRAPHICS)
-            .SetMultisampling(vulkanContext.GetDevice().GetProperties().maxSampleCount)
-            .AddColorAndResolveAttachments(colorAttachmentDescription, resolveAttachmentDescription)
+        RenderPassBuilder builder(vulkanContext);
+
+        builder.SetBindPoint(VK_PIPELINE_BIND_POINT_GRAPHICS);
+        builder.SetMultisampling(sampleCount);
+
+        if (multisampled)
+        {
+            builder.AddColorAndResolveAttachments(colorAttachmentDescription, resolveAttachmentDescription);
+        }
+        else
+        {
+            builder.AddColorAttachment(colorAttachmentDescription);
+        }
+
+        return builder
             .AddDepthStencilAttachment(depthStencilAttachmentDescription)
             .SetPreviousBarriers(std::move(previousBarriers))
             .SetFollowingBarriers(std::move(followingBarriers))
@@ -78,78 +93,81 @@ namespace ForwardStageDetails
         const std::vector<RenderTarget>& swapchainTargets = swapchain.GetRenderTargets();
         framebuffers.reserve(swapchainTargets.size());
 
-        std::vector<VkImageView> attachments = { renderContext.colorTarget.view, VK_NULL_HANDLE, renderContext.depthTarget.view };
+        // Without multisampling scene is rendered directly to the swapchain image and there's no color target
+        const bool multisampled = renderContext.sampleCount != VK_SAMPLE_COUNT_1_BIT;
+        const size_t swapchainAttachmentIndex = multisampled ? 1 : 0;
+
+        std::vector<VkImageView> attachments = multisampled
+            ? std::vector<VkImageView>{ renderContext.colorTarget.view, VK_NULL_HANDLE, renderContext.depthTarget.view }
+            : std::vector<VkImageView>{ VK_NULL_HANDLE, renderContext.depthTarget.view };
 
         std::ranges::transform(swapchainTargets, std::back_inserter(framebuffers), [&](const RenderTarget& target) {
-            attachments[1] = target.view;
+            attachments[swapchainAttachmentIndex] = target.view;
             return VulkanUtils::CreateFrameBuffer(renderPass, swapchain.GetExtent(), attachments, vulkanContext);
         });
         
         return framebuffers;
     }
 
-    static DescriptorSetLayout GetMeshDescriptorSetLayout(const VulkanContext& vulkanContext)
-    {
-        // TODO: Parse from SPIR-V reflection
-        return vulkanContext.GetDescriptorSetsManager().GetDescriptorSetLayoutBuilder()
-            .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_MESH_BIT_EXT) // Vertices
-            .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_MESH_BIT_EXT) // MeshletData
-            .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT) // Meshlets
-            .AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT) // Draws
-            .AddBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_TASK_BIT_EXT) // TaskCommands
-            .Build();
-    }
-
-    static DescriptorSetLayout GetVertexDescriptorSetLayout(const VulkanContext& vulkanContext)
+    static std::vector<ShaderDescription> GetShaderDescriptions(const GraphicsPipelineType type)
     {
-        return vulkanContext.GetDescriptorSetsManager().GetDescriptorSetLayoutBuilder()
-            .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // Draws
-            .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // IndirectCommands
-            .Build();
-    }
-
-    static std::vector<ShaderModule> GetShaderModules(const GraphicsPipelineType type, const VulkanContext& vulkanContext)
-    {
-        const ShaderManager& shaderManager = vulkanContext.GetShaderManager();
-
-        std::vector<ShaderModule> shaderModules;
+        std::vector<ShaderDescription> shaderDescriptions;
 
         if (type == GraphicsPipelineType::eMesh)
         {
-            shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(taskShaderPath), ShaderType::eTask));
-            shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(meshShaderPath), ShaderType::eMesh));
+            shaderDescriptions.push_back({ taskShaderPath, ShaderType::eTask });
+            shaderDescriptions.push_back({ meshShaderPath, ShaderType::eMesh });
         }
         else
         {
-            shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(vertexShaderPath), ShaderType::eVertex));
+            shaderDescriptions.push_back({ vertexShaderPath, ShaderType::eVertex });
         }
 
-        shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(fragmentShaderPath), ShaderType::eFragment));
+        shaderDescriptions.push_back({ fragmentShaderPath, ShaderType::eFragment });
 
-        return shaderModules;
+        return shaderDescriptions;
+    }
+
+    static uint32_t GetPermutation(const GraphicsPipelineType type, const DebugView debugView,
+        const VkSampleCountFlagBits sampleCount)
+    {
+        return static_cast<uint32_t>(type) | static_cast<uint32_t>(debugView) << 8 |
+            static_cast<uint32_t>(sampleCount) << 16;
+    }
+
+    static GraphicsPipelineType GetPipelineType(const uint32_t permutation)
+    {
+        return static_cast<GraphicsPipelineType>(permutation & 0xFF);
+    }
+
+    static SpecializationConstants GetSpecializationConstants(const DebugView debugView)
+    {
+        SpecializationConstants specializationConstants;
+        specializationConstants
+            .Set(gpu::specVisualizeMeshlets, debugView == DebugView::eMeshlets)
+            .Set(gpu::specVisualizeLods, debugView == DebugView::eLods);
+
+        return specializationConstants;
     }
 }
 
 ForwardStage::ForwardStage(const VulkanContext& aVulkanContext, RenderContext& aRenderContext)
     : RenderStage{ aVulkanContext, aRenderContext }
+    , pipelineReloader{ aVulkanContext }
 {
     using namespace ForwardStageDetails;
     
-    renderPass = CreateRenderPass(*vulkanContext);
+    renderPassSampleCount = renderContext->sampleCount;
+    renderPass = CreateRenderPass(*vulkanContext, renderPassSampleCount);
     framebuffers = CreateFramebuffers(renderPass, *vulkanContext, *renderContext);
-    
-    if (vulkanContext->GetDevice().GetProperties().meshShadersSupported)
+
+    const std::vector<PipelineDescription> descriptions = GetPipelineDescriptions(RenderOptions::Get().GetDebugView());
+
+    for (auto& [permutation, pipeline] : CreatePipelines(descriptions, *vulkanContext))
     {
-        descriptors[GraphicsPipelineType::eMesh] = { VK_NULL_HANDLE, GetMeshDescriptorSetLayout(*vulkanContext) };
-        
-        graphicsPipelines[GraphicsPipelineType::eMesh] = CreateMeshPipeline();
-        Assert(graphicsPipelines[GraphicsPipelineType::eMesh].IsValid());
+        Assert(pipeline.IsValid());
+        graphicsPipelines.emplace(permutation, std::move(pipeline));
     }
-    
-    descriptors[GraphicsPipelineType::eVertex] = { VK_NULL_HANDLE, GetVertexDescriptorSetLayout(*vulkanContext) };
-    
-    graphicsPipelines[GraphicsPipelineType::eVertex] = CreateVertexPipeline();
-    Assert(graphicsPipelines[GraphicsPipelineType::eVertex].IsValid());
 }
 
 ForwardStage::~ForwardStage()
@@ -158,165 +176,335 @@ ForwardStage::~ForwardStage()
 }
 
 void ForwardStage::Prepare(const Scene& scene)
+{}
+
+void ForwardStage::Execute(const Frame& frame)
 {
-    DescriptorSetManager& descriptorSetManager = vulkanContext->GetDescriptorSetsManager();
+    using namespace VulkanUtils;
     
-    if (descriptors.contains(GraphicsPipelineType::eMesh))
+    const RenderOptions& renderOptions = RenderOptions::Get();
+
+    const GraphicsPipelineType pipelineType = renderOptions.GetGraphicsPipelineType();
+    const Pipeline& graphicsPipeline = GetPipeline(pipelineType, renderOptions.GetDebugView());
+    const VkPipeline pipeline = graphicsPipeline;
+    const VkPipelineLayout pipelineLayout = graphicsPipeline.GetLayout();
+    const VkFramebuffer framebuffer = framebuffers[frame.swapchainImageIndex];
+    const VkExtent2D extent = vulkanContext->GetSwapchain().GetExtent();
+    const std::array<VkDescriptorSet, 2> descriptorSets = {
+        renderContext->bindlessTextures->GetDescriptorSet(), renderContext->frameDataDescriptorSets[frame.index] };
+
+    // Resolve attachment goes in between color and depth ones, its clear value is ignored
+    const uint32_t depthAttachmentIndex = renderPassSampleCount != VK_SAMPLE_COUNT_1_BIT ? 2 : 1;
+
+    frame.recorder->Record([=, this](VkCommandBuffer commandBuffer) {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = framebuffer;
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = extent;
+
+        std::array<VkClearValue, 3> clearValues{};
+        clearValues[0].color = { { 0.73f, 0.95f, 1.0f, 1.0f } };
+        clearValues[depthAttachmentIndex].depthStencil = { 0.0f, 0 };
+
+        renderPassInfo.clearValueCount = depthAttachmentIndex + 1;
+        renderPassInfo.pClearValues = clearValues.data();
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    });
+
+    frame.recorder->RecordSecondary([=, this, &frame](VkCommandBuffer commandBuffer) {
+        GpuTimers::Begin(commandBuffer, frame.timestampQueryPool, frame.index, GpuTimer::eForward);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+        VkViewport viewport = GetViewport(static_cast<float>(extent.width), static_cast<float>(extent.height));
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        const VkRect2D scissor = GetScissor(extent);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+            0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+
+        if (pipelineType == GraphicsPipelineType::eMesh)
+        {
+            ExecuteMesh(commandBuffer);
+        }
+        else
+        {
+            ExecuteVertex(commandBuffer, pipelineLayout);
+        }
+
+        GpuTimers::End(commandBuffer, frame.timestampQueryPool, frame.index, GpuTimer::eForward);
+    }, renderPass, framebuffer);
+
+    frame.recorder->Record([](VkCommandBuffer commandBuffer) {
+        vkCmdEndRenderPass(commandBuffer);
+    });
+}
+
+void ForwardStage::RecreateFramebuffers()
+{
+    using namespace ForwardStageDetails;
+
+    DeletionQueue& deletionQueue = vulkanContext->GetDeletionQueue();
+
+    deletionQueue.Enqueue(framebuffers);
+
+    // Pipelines of the previous sample count stay cached, they're compatible with the pass of the same sample count
+    if (renderContext->sampleCount != renderPassSampleCount)
     {
-        auto& pair = descriptors[GraphicsPipelineType::eMesh];
-        
-        pair = descriptorSetManager.GetDescriptorSetBuilder(pair.second, DescriptorScope::eSceneRenderer)
-            .Bind(0, renderContext->vertexBuffer)
-            .Bind(1, renderContext->meshletDataBuffer)
-            .Bind(2, renderContext->meshletBuffer)
-            .Bind(3, renderContext->drawBuffer)
-            .Bind(4, renderContext->commandBuffer)
-            .Build();
+        // Running or queued reload builds got the pass by value, it has to outlive them
+        if (pipelineReloader.IsRunning())
+        {
+            retiredRenderPasses.push_back(std::move(renderPass));
+        }
+        else
+        {
+            deletionQueue.Enqueue(std::move(renderPass));
+        }
+
+        renderPassSampleCount = renderContext->sampleCount;
+        renderPass = CreateRenderPass(*vulkanContext, renderPassSampleCount);
     }
-    
-    auto& pair = descriptors[GraphicsPipelineType::eVertex];
-    
-    pair = descriptorSetManager.GetDescriptorSetBuilder(pair.second, DescriptorScope::eSceneRenderer)
-        .Bind(0, renderContext->drawBuffer)
-        .Bind(1, renderContext->commandBuffer)
-        .Build();
+
+    framebuffers = ForwardStageDetails::CreateFramebuffers(renderPass, *vulkanContext, *renderContext);
 }
 
-void ForwardStage::Execute(const Frame& frame)
+void ForwardStage::TryReloadShaders(const std::span<const std::string> changedFiles)
 {
-    using namespace VulkanUtils;
-    
-    const GraphicsPipelineType pipelineType = RenderOptions::Get().GetGraphicsPipelineType();
-    const Pipeline& graphicsPipeline = graphicsPipelines[pipelineType];
-    
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffers[frame.swapchainImageIndex];
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = vulkanContext->GetSwapchain().GetExtent();
-
-    std::array<VkClearValue, 3> clearValues{};
-    clearValues[0].color = { { 0.73f, 0.95f, 1.0f, 1.0f } };
-    clearValues[2].depthStencil = { 0.0f, 0 };
-
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
-    
-    const VkCommandBuffer commandBuffer = frame.commandBuffer;
+    using namespace ForwardStageDetails;
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+    const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
 
-    const VkExtent2D extent = vulkanContext->GetSwapchain().GetExtent();
-    VkViewport viewport = GetViewport(static_cast<float>(extent.width), static_cast<float>(extent.height));
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    // Only permutations of the current debug view are rebuilt, the rest are dropped on apply and recreated on demand
+    std::vector<PipelineDescription> descriptions = GetPipelineDescriptions(RenderOptions::Get().GetDebugView());
+
+    std::erase_if(descriptions, [&](const PipelineDescription& description) {
+        return std::ranges::none_of(GetShaderDescriptions(description.type), [&](const auto& shaderDescription) {
+            return shaderManager.IsShaderAffected(FilePath(shaderDescription.path), changedFiles);
+        });
+    });
+
+    if (descriptions.empty())
+    {
+        return;
+    }
 
-    const VkRect2D scissor = GetScissor(extent);
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    pipelineReloader.Start([&context = *vulkanContext, descriptions = std::move(descriptions)]() {
+        return CreatePipelines(descriptions, context);
+    });
+}
+
+bool ForwardStage::ApplyReloadedShaders()
+{
+    using namespace ForwardStageDetails;
 
-    vkCmdPushConstants(commandBuffer, graphicsPipeline.GetLayout(),
-        pipelineType == GraphicsPipelineType::eMesh ? VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT :
-        VK_SHADER_STAGE_VERTEX_BIT, 0, static_cast<uint32_t>(sizeof(gpu::PushConstants)), &renderContext->globals);
+    std::optional<PipelineReloader::KeyedPipelines> pipelines = pipelineReloader.TryTake();
 
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline.GetLayout(),
-        0, 1, &descriptors[pipelineType].first, 0, nullptr);
+    if (!pipelines)
+    {
+        return false;
+    }
 
-    if (pipelineType == GraphicsPipelineType::eMesh)
+    if (!pipelineReloader.IsRunning())
     {
-        ExecuteMesh(frame);
+        for (RenderPass& retiredRenderPass : retiredRenderPasses)
+        {
+            vulkanContext->GetDeletionQueue().Enqueue(std::move(retiredRenderPass));
+        }
+
+        retiredRenderPasses.clear();
     }
-    else
+
+    bool applied = false;
+
+    for (auto& [permutation, newPipeline] : *pipelines)
     {
-        ExecuteVertex(frame);
+        if (!newPipeline.IsValid())
+        {
+            continue;
+        }
+
+        const GraphicsPipelineType type = GetPipelineType(permutation);
+
+        std::erase_if(graphicsPipelines, [&](auto& entry) {
+            if (GetPipelineType(entry.first) != type)
+            {
+                return false;
+            }
+
+            vulkanContext->GetDeletionQueue().Enqueue(std::move(entry.second));
+            return true;
+        });
+
+        graphicsPipelines.emplace(permutation, std::move(newPipeline));
+        applied = true;
     }
 
-    vkCmdEndRenderPass(commandBuffer);
+    return applied;
 }
 
-void ForwardStage::RecreateFramebuffers()
+std::vector<ForwardStage::PipelineDescription> ForwardStage::GetPipelineDescriptions(const DebugView debugView) const
 {
-    VulkanUtils::DestroyFramebuffers(framebuffers, *vulkanContext);
-    framebuffers = ForwardStageDetails::CreateFramebuffers(renderPass, *vulkanContext, *renderContext);
+    const RenderOptions& renderOptions = RenderOptions::Get();
+
+    std::vector<PipelineDescription> descriptions;
+
+    for (const GraphicsPipelineType type : OptionValues::graphicsPipelineTypes)
+    {
+        if (renderOptions.IsGraphicsPipelineTypeSupported(type))
+        {
+            descriptions.push_back(GetPipelineDescription(type, debugView));
+        }
+    }
+
+    return descriptions;
 }
 
-void ForwardStage::TryReloadShaders()
+ForwardStage::PipelineDescription ForwardStage::GetPipelineDescription(const GraphicsPipelineType type,
+    const DebugView debugView) const
+{
+    return { type, debugView, renderPassSampleCount, renderPass,
+        { renderContext->bindlessTextures->GetLayout(), renderContext->frameDataDescriptorSetLayout } };
+}
+
+const Pipeline& ForwardStage::GetPipeline(const GraphicsPipelineType type, const DebugView debugView)
 {
     using namespace ForwardStageDetails;
-    
-    for (auto& [type, pipeline] : graphicsPipelines)
+
+    const uint32_t permutation = GetPermutation(type, debugView, renderPassSampleCount);
+
+    auto it = graphicsPipelines.find(permutation);
+
+    if (it == graphicsPipelines.end())
     {
-        Pipeline newPipeline = type == GraphicsPipelineType::eMesh ? CreateMeshPipeline() : CreateVertexPipeline();
-        
-        if (newPipeline.IsValid())
-        {
-            pipeline = std::move(newPipeline);
-        }
+        PipelineReloader::KeyedPipelines pipelines = CreatePipelines({ GetPipelineDescription(type, debugView) },
+            *vulkanContext);
+        Assert(pipelines.front().second.IsValid());
+
+        it = graphicsPipelines.emplace(permutation, std::move(pipelines.front().second)).first;
     }
+
+    return it->second;
 }
 
-Pipeline ForwardStage::CreateMeshPipeline()
+PipelineReloader::KeyedPipelines ForwardStage::CreatePipelines(
+    const std::vector<PipelineDescription>& descriptions, const VulkanContext& vulkanContext)
+{
+    using namespace ForwardStageDetails;
+
+    const ShaderManager& shaderManager = vulkanContext.GetShaderManager();
+
+    std::vector<std::vector<std::future<ShaderModule>>> shaderModules;
+    shaderModules.reserve(descriptions.size());
+
+    for (const PipelineDescription& description : descriptions)
+    {
+        shaderModules.push_back(shaderManager.CreateShaderModulesAsync(GetShaderDescriptions(description.type)));
+    }
+
+    PipelineReloader::KeyedPipelines pipelines;
+    pipelines.reserve(descriptions.size());
+
+    for (size_t i = 0; i < descriptions.size(); ++i)
+    {
+        const PipelineDescription& description = descriptions[i];
+
+        std::vector<ShaderModule> pipelineShaderModules = ShaderManager::WaitShaderModules(std::move(shaderModules[i]));
+
+        pipelines.emplace_back(GetPermutation(description.type, description.debugView, description.sampleCount),
+            description.type == GraphicsPipelineType::eMesh
+                ? CreateMeshPipeline(std::move(pipelineShaderModules), description, vulkanContext)
+                : CreateVertexPipeline(std::move(pipelineShaderModules), description, vulkanContext));
+    }
+
+    return pipelines;
+}
+
+Pipeline ForwardStage::CreateMeshPipeline(std::vector<ShaderModule>&& shaderModules,
+    const PipelineDescription& description, const VulkanContext& vulkanContext)
 {
     using namespace ForwardStageDetails;
-    
-    std::vector<ShaderModule> shaderModules = GetShaderModules(GraphicsPipelineType::eMesh, *vulkanContext);
     
     if (!std::ranges::all_of(shaderModules, &ShaderModule::IsValid))
     {
         return {};
     }
 
-    return GraphicsPipelineBuilder(*vulkanContext)
-        .SetDescriptorSetLayouts({ descriptors[GraphicsPipelineType::eMesh].second })
-        .AddPushConstantRange({ VK_SHADER_STAGE_MESH_BIT_EXT | VK_SHADER_STAGE_TASK_BIT_EXT, 0, sizeof(gpu::PushConstants) })
+    return GraphicsPipelineBuilder(vulkanContext)
+        .SetDescriptorSetLayouts(std::vector(description.layouts))
         .SetShaderModules(std::move(shaderModules))
+        .SetSpecializationConstants(GetSpecializationConstants(description.debugView))
         .SetPolygonMode(PolygonMode::eFill)
-        .SetMultisampling(vulkanContext->GetDevice().GetProperties().maxSampleCount)
+        .SetMultisampling(description.sampleCount)
         .SetDepthState(true, true, VK_COMPARE_OP_GREATER_OR_EQUAL)
-        .SetRenderPass(renderPass)
+        .SetRenderPass(description.renderPass)
         .Build();
 }
 
-Pipeline ForwardStage::CreateVertexPipeline()
+Pipeline ForwardStage::CreateVertexPipeline(std::vector<ShaderModule>&& shaderModules,
+    const PipelineDescription& description, const VulkanContext& vulkanContext)
 {
     using namespace ForwardStageDetails;
     
-    std::vector<ShaderModule> shaderModules = GetShaderModules(GraphicsPipelineType::eVertex, *vulkanContext);
-    
     if (!std::ranges::all_of(shaderModules, &ShaderModule::IsValid))
     {
         return {};
     }
     
-    return GraphicsPipelineBuilder(*vulkanContext)
-        .SetDescriptorSetLayouts({ descriptors[GraphicsPipelineType::eVertex].second })
-        .AddPushConstantRange({ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(gpu::PushConstants) })
+    return GraphicsPipelineBuilder(vulkanContext)
+        .SetDescriptorSetLayouts(std::vector(description.layouts))
         .SetShaderModules(std::move(shaderModules))
+        .SetSpecializationConstants(GetSpecializationConstants(description.debugView))
         .SetVertexData(SceneHelpers::GetVertexBindings(), SceneHelpers::GetVertexAttributes())
+        .AddPushConstantRange({ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(gpu::ForwardPushConstants) })
         .SetInputTopology(InputTopology::eTriangleList)
         .SetPolygonMode(PolygonMode::eFill)
         .SetCullMode(CullMode::eBack, false)
-        .SetMultisampling(vulkanContext->GetDevice().GetProperties().maxSampleCount)
+        .SetMultisampling(description.sampleCount)
         .SetDepthState(true, true, VK_COMPARE_OP_GREATER_OR_EQUAL)
-        .SetRenderPass(renderPass)
+        .SetRenderPass(description.renderPass)
         .Build();
 }
 
-void ForwardStage::ExecuteMesh(const Frame& frame) const
+void ForwardStage::ExecuteMesh(VkCommandBuffer commandBuffer) const
 {
-    vkCmdDrawMeshTasksIndirectEXT(frame.commandBuffer, renderContext->commandCountBuffer, 0, 1, 0);
+    vkCmdDrawMeshTasksIndirectEXT(commandBuffer, renderContext->commandCountBuffer, 0, 1, 0);
 }
 
-void ForwardStage::ExecuteVertex(const Frame& frame) const
+void ForwardStage::ExecuteVertex(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
 {
-    const VkCommandBuffer commandBuffer = frame.commandBuffer;
-    
-    const VkBuffer vertexBuffers[] = { renderContext->vertexBuffer };
+    const SceneGeometry& geometry = *renderContext->geometry;
+
+    const VkBuffer vertexBuffers[] = { geometry.GetVertexBuffer() };
     const VkDeviceSize offsets[] = { 0 };
     
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(commandBuffer, renderContext->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-    vkCmdDrawIndexedIndirectCount(commandBuffer, renderContext->commandBuffer, sizeof(uint32_t), 
-        renderContext->commandCountBuffer, 0, renderContext->globals.drawCount, sizeof(gpu::IndirectCommand));
+    // Batches of 32-bit and 16-bit index lods, see PrimitiveCull.comp
+    const auto drawBatch = [&](const Buffer& indexBuffer, const VkIndexType indexType, const CommandBatch& batch) {
+        if (!indexBuffer.IsValid() || batch.maxCount == 0)
+        {
+            return;
+        }
+
+        const gpu::ForwardPushConstants pushConstants = { .commandOffset = batch.offset };
+
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+            static_cast<uint32_t>(sizeof(gpu::ForwardPushConstants)), &pushConstants);
+
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+
+        vkCmdDrawIndexedIndirectCount(commandBuffer, renderContext->commandBuffer,
+            batch.offset * sizeof(gpu::IndirectCommand) + sizeof(uint32_t), renderContext->commandCountBuffer,
+            batch.countIndex * sizeof(uint32_t), batch.maxCount, sizeof(gpu::IndirectCommand));
+    };
+
+    const auto& [batch, shortBatch] = renderContext->vertexCommandBatches;
+
+    drawBatch(geometry.GetIndexBuffer(), VK_INDEX_TYPE_UINT32, batch);
+    drawBatch(geometry.GetShortIndexBuffer(), VK_INDEX_TYPE_UINT16, shortBatch);
 }
@@ -1,6 +1,8 @@
 #include "Engine/Render/RenderStages/PrimitiveCullStage.hpp"
 
 #include "Shaders/Common.h"
+#include "Engine/Render/RenderOptions.hpp"
+#include "Engine/Render/Vulkan/Buffer/BufferUtils.hpp"
 #include "Engine/Render/Vulkan/Pipelines/ComputePipelineBuilder.hpp"
 #include "Engine/Render/Vulkan/Synchronization/SynchronizationUtils.hpp"
 
@@ -8,20 +10,60 @@ namespace PrimitiveCullStageDetails
 {
     static constexpr std::string_view shaderPath = "~/Shaders/Culling/PrimitiveCull.comp";
 
-    static std::tuple<VkDescriptorSet, DescriptorSetLayout> CreateDescriptors(const RenderContext& renderContext, 
-        const VulkanContext& vulkanContext)
+    enum PermutationBits : uint32_t
     {
-        return vulkanContext.GetDescriptorSetsManager().GetDescriptorSetBuilder(DescriptorScope::eSceneRenderer)
-            .Bind(0, renderContext.primitiveBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-            .Bind(1, renderContext.drawBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-            .Bind(2, renderContext.commandCountBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-            .Bind(3, renderContext.commandBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
-            .Build();
+        eMeshPipeline = 1 << 0,
+        eUseLod = 1 << 1,
+        eVisualizeLods = 1 << 2,
+        eStreamLods = 1 << 3,
+    };
+
+    static uint32_t GetPermutation(const RenderOptions& renderOptions, const RenderContext& renderContext)
+    {
+        uint32_t permutation = 0;
+
+        if (renderOptions.GetGraphicsPipelineType() == GraphicsPipelineType::eMesh)
+        {
+            permutation |= eMeshPipeline;
+        }
+        if (renderOptions.GetUseLod())
+        {
+            permutation |= eUseLod;
+        }
+        if (renderOptions.GetDebugView() == DebugView::eLods)
+        {
+            permutation |= eVisualizeLods;
+        }
+        if (renderContext.lodStreaming)
+        {
+            permutation |= eStreamLods;
+        }
+
+        return permutation;
+    }
+
+    static SpecializationConstants GetSpecializationConstants(const uint32_t permutation)
+    {
+        SpecializationConstants specializationConstants;
+        specializationConstants
+            .Set(gpu::specMeshPipeline, (permutation & eMeshPipeline) != 0)
+            .Set(gpu::specUseLod, (permutation & eUseLod) != 0)
+            .Set(gpu::specVisualizeLods, (permutation & eVisualizeLods) != 0)
+            .Set(gpu::specStreamLods, (permutation & eStreamLods) != 0)
+            .Set(gpu::specPrimitiveCullWgSize, gpu::primitiveCullWgSize);
+
+        return specializationConstants;
+    }
+
+    static std::vector<VkDescriptorSetLayout> GetDescriptorSetLayouts(const RenderContext& renderContext)
+    {
+        return { renderContext.bindlessTextures->GetLayout(), renderContext.frameDataDescriptorSetLayout };
     }
 }
 
 PrimitiveCullStage::PrimitiveCullStage(const VulkanContext& aVulkanContext, RenderContext& aRenderContext)
     : RenderStage{ aVulkanContext, aRenderContext }
+    , pipelineReloader{ aVulkanContext }
 {}
 
 PrimitiveCullStage::~PrimitiveCullStage() = default;
@@ -30,88 +72,189 @@ void PrimitiveCullStage::Prepare(const Scene& scene)
 {
     using namespace PrimitiveCullStageDetails;
 
-    std::tie(descriptorSet, descriptorSetLayout) = CreateDescriptors(*renderContext, *vulkanContext);
-
-    if (!pipeline.IsValid())
-    {
-        pipeline = CreatePipeline();
-        Assert(pipeline.IsValid());
-    }
+    GetPipeline(GetPermutation(RenderOptions::Get(), *renderContext));
 }
 
 void PrimitiveCullStage::Execute(const Frame& frame)
 {
-    using namespace SynchronizationUtils;
+    using namespace PrimitiveCullStageDetails;
+
+    const RenderOptions& renderOptions = RenderOptions::Get();
+
+    // Output commands buffer is selected by globals.culledCommands, see SceneRenderer::Process
+    const std::array<VkDescriptorSet, 2> descriptorSets = {
+        renderContext->bindlessTextures->GetDescriptorSet(), renderContext->frameDataDescriptorSets[frame.index] };
+
+    // Permutations are created on first use, option switches after that are free
+    const Pipeline& pipeline = GetPipeline(GetPermutation(renderOptions, *renderContext));
+    const VkPipeline vkPipeline = pipeline;
+    const VkPipelineLayout pipelineLayout = pipeline.GetLayout();
+
+    const bool streamLods = renderContext->lodStreaming;
+
+    frame.recorder->RecordSecondary([=, this, &frame](VkCommandBuffer cmd) {
+        using namespace SynchronizationUtils;
+
+        GpuTimers::Begin(cmd, frame.timestampQueryPool, frame.index, GpuTimer::eCull);
+
+        // Lod requests of the previous frame are still being copied to its readback buffer
+        constexpr PipelineBarrier clearCommandCountBarrier = {
+            .srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT };
+
+        SetMemoryBarrier(cmd, clearCommandCountBarrier);
+
+        // Task dispatch y and z in between stay 1
+        vkCmdFillBuffer(cmd, renderContext->commandCountBuffer, gpu::commandCountIndex * sizeof(uint32_t),
+            sizeof(uint32_t), 0);
+        vkCmdFillBuffer(cmd, renderContext->commandCountBuffer, gpu::shortCommandCountIndex * sizeof(uint32_t),
+            sizeof(uint32_t), 0);
+
+        if (streamLods)
+        {
+            vkCmdFillBuffer(cmd, renderContext->lodRequestBuffer, 0, VK_WHOLE_SIZE, gpu::lodNotRequested);
+        }
+
+        // TODO: I've seen that driver actually doesn't care about buffer barriers but let's have them, it's nicer
+        // TODO: Do you set this as a single barrier or better to have 2 separate ones?
+        constexpr PipelineBarrier previousFrameAndClearBarrier = {
+            .srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT };
+
+        SetMemoryBarrier(cmd, previousFrameAndClearBarrier);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipeline);
 
-    const VkCommandBuffer cmd = frame.commandBuffer;
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
 
-    constexpr PipelineBarrier clearCommandCountBarrier = {
-        .srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
-        .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
-        .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT };
+        const auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(renderContext->globals.drawCount) /
+            static_cast<float>(gpu::primitiveCullWgSize)));
 
-    SetMemoryBarrier(cmd, clearCommandCountBarrier);
+        vkCmdDispatch(cmd, groupCountX, 1, 1);
 
-    vkCmdFillBuffer(cmd, renderContext->commandCountBuffer, 0, sizeof(uint32_t), 0);
+        // TODO: Same about 2 barriers as above
+        constexpr PipelineBarrier afterCullBarrier = {
+            .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT |
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                VK_ACCESS_TRANSFER_READ_BIT };
 
-    // TODO: I've seen that driver actually doesn't care about buffer barriers but let's have them, it's nicer
-    // TODO: Do you set this as a single barrier or better to have 2 separate ones?
-    constexpr PipelineBarrier previousFrameAndClearBarrier = {
-        .srcStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-        .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
-        .dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT };
+        SetMemoryBarrier(cmd, afterCullBarrier);
 
-    SetMemoryBarrier(cmd, previousFrameAndClearBarrier);
+        // LodStreamer reads it once the frame is complete
+        if (streamLods)
+        {
+            BufferUtils::CopyBufferToBuffer(cmd, renderContext->lodRequestBuffer,
+                renderContext->lodRequestReadbackBuffers[frame.index]);
 
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+            constexpr PipelineBarrier lodRequestReadbackBarrier = {
+                .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstStage = VK_PIPELINE_STAGE_HOST_BIT,
+                .dstAccessMask = VK_ACCESS_HOST_READ_BIT };
 
-    vkCmdPushConstants(cmd, pipeline.GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, 
-        static_cast<uint32_t>(sizeof(gpu::PushConstants)), &renderContext->globals);
+            SetMemoryBarrier(cmd, lodRequestReadbackBarrier);
+        }
 
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.GetLayout(), 0, 1, &descriptorSet, 0, nullptr);
+        GpuTimers::End(cmd, frame.timestampQueryPool, frame.index, GpuTimer::eCull);
+    });
+}
+
+void PrimitiveCullStage::TryReloadShaders(const std::span<const std::string> changedFiles)
+{
+    using namespace PrimitiveCullStageDetails;
+
+    // Pipelines are created on first use with the latest shaders anyway
+    if (pipelines.empty() || !vulkanContext->GetShaderManager().IsShaderAffected(FilePath(shaderPath), changedFiles))
+    {
+        return;
+    }
 
-    const auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(renderContext->globals.drawCount) /
-        static_cast<float>(gpu::primitiveCullWgSize)));
+    // All permutations created so far are rebuilt in one batch, so switching options after reload stays free
+    std::vector<uint32_t> permutations;
+    permutations.reserve(pipelines.size());
+    std::ranges::copy(pipelines | std::views::keys, std::back_inserter(permutations));
 
-    vkCmdDispatch(cmd, groupCountX, 1, 1);
+    pipelineReloader.Start([&context = *vulkanContext, permutations = std::move(permutations),
+        layouts = GetDescriptorSetLayouts(*renderContext)]() {
+        return CreatePipelines(permutations, layouts, context);
+    });
+}
+
+bool PrimitiveCullStage::ApplyReloadedShaders()
+{
+    std::optional<PipelineReloader::KeyedPipelines> newPipelines = pipelineReloader.TryTake();
 
-    // TODO: Same about 2 barriers as above
-    constexpr PipelineBarrier afterCullBarrier = {
-        .srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
-        .dstStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT,
-        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT };
+    // Permutations share the shader, so either all of them are replaced or none
+    if (!newPipelines || !std::ranges::all_of(*newPipelines | std::views::values, &Pipeline::IsValid))
+    {
+        return false;
+    }
+
+    // Permutations created on demand during the build already use the latest shader
+    for (auto& [permutation, newPipeline] : *newPipelines)
+    {
+        vulkanContext->GetDeletionQueue().Enqueue(std::exchange(pipelines[permutation], std::move(newPipeline)));
+    }
 
-    SetMemoryBarrier(cmd, afterCullBarrier);
+    return true;
 }
 
-void PrimitiveCullStage::TryReloadShaders()
+const Pipeline& PrimitiveCullStage::GetPipeline(const uint32_t permutation)
 {
-    if (Pipeline newPipeline = CreatePipeline(); newPipeline.IsValid())
+    auto it = pipelines.find(permutation);
+
+    if (it == pipelines.end())
     {
-        pipeline = std::move(newPipeline);
+        PipelineReloader::KeyedPipelines newPipelines = CreatePipelines(std::span(&permutation, 1),
+            GetDescriptorSetLayouts(*renderContext), *vulkanContext);
+        Assert(newPipelines.front().second.IsValid());
+
+        it = pipelines.emplace(permutation, std::move(newPipelines.front().second)).first;
     }
+
+    return it->second;
 }
 
-Pipeline PrimitiveCullStage::CreatePipeline() const
+PipelineReloader::KeyedPipelines PrimitiveCullStage::CreatePipelines(const std::span<const uint32_t> permutations,
+    const std::vector<VkDescriptorSetLayout>& layouts, const VulkanContext& vulkanContext)
 {
     using namespace PrimitiveCullStageDetails;
 
-    ShaderModule shaderModule = vulkanContext->GetShaderManager().CreateShaderModule(FilePath(shaderPath), 
-        ShaderType::eCompute);
+    const ShaderModule shaderModule = vulkanContext.GetShaderManager().CreateShaderModule(
+        FilePath(shaderPath), ShaderType::eCompute);
+
+    PipelineReloader::KeyedPipelines newPipelines;
+    newPipelines.reserve(permutations.size());
+
+    for (const uint32_t permutation : permutations)
+    {
+        newPipelines.emplace_back(permutation, CreatePipeline(shaderModule, permutation, layouts, vulkanContext));
+    }
+
+    return newPipelines;
+}
+
+Pipeline PrimitiveCullStage::CreatePipeline(const ShaderModule& shaderModule, const uint32_t permutation,
+    const std::vector<VkDescriptorSetLayout>& layouts, const VulkanContext& vulkanContext)
+{
+    using namespace PrimitiveCullStageDetails;
 
     if (!shaderModule.IsValid())
     {
         return {};
     }
 
-    std::vector<VkDescriptorSetLayout> layouts = { descriptorSetLayout };
-
-    return ComputePipelineBuilder(*vulkanContext)
-        .SetDescriptorSetLayouts(std::move(layouts)) // TODO: Why telling stage here?? We need reflection...
-        .AddPushConstantRange({ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(gpu::PushConstants) })
-        .SetShaderModule(std::move(shaderModule))
+    return ComputePipelineBuilder(vulkanContext)
+        .SetDescriptorSetLayouts(layouts)
+        .SetShaderModule(shaderModule)
+        .SetSpecializationConstants(GetSpecializationConstants(permutation))
         .Build();
 }
\ No newline at end of file
@@ -17,5 +17,13 @@ void RenderStage::Execute(const Frame& frame)
 void RenderStage::RecreateFramebuffers()
 {}
 
-void RenderStage::TryReloadShaders()
+void RenderStage::TryReloadShaders(std::span<const std::string> changedFiles)
 {}
+
+bool RenderStage::ApplyReloadedShaders()
+{
+    return false;
+}
+
+void RenderStage::OnBuffersRelocated()
+{}
\ No newline at end of file
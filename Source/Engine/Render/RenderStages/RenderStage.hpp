@@ -22,7 +22,16 @@ public:
     virtual void Execute(const Frame& frame);
     
     virtual void RecreateFramebuffers();
-    virtual void TryReloadShaders();
+    // Changed files are relative to the shaders dir, empty means everything has to be reloaded
+    virtual void TryReloadShaders(std::span<const std::string> changedFiles);
+
+    // Swaps in pipelines rebuilt by TryReloadShaders once they are ready, called at the frame boundary.
+    // Returns true if any pipeline got replaced
+    virtual bool ApplyReloadedShaders();
+
+    // Relocatable buffers got new handles (see MemoryManager::Defragment), descriptors written with the old ones
+    // have to be rebuilt. Device addresses are refreshed by the owner
+    virtual void OnBuffersRelocated();
     
 protected:
     const VulkanContext* vulkanContext = nullptr;
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "Utils/OffsetAllocator.hpp"
+#include "Engine/Scene/SceneDataStructures.hpp"
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
+#include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
+
+class VulkanContext;
+class CommandRecorder;
+
+// Device local arenas with geometry of resident primitives. Each primitive gets its own ranges sub-allocated in them,
+// so primitives are added and removed at runtime without re-uploading the rest, only their gpu::Primitive and lods
+// are patched. Index and meshlet arenas are allocated per lod: coarsest lod of a resident primitive is always there,
+// finer ones are added and evicted at runtime (see LodStreamer), so these arenas can be smaller than the scene
+class SceneGeometry
+{
+public:
+    static constexpr uint32_t invalidSlot = std::numeric_limits<uint32_t>::max();
+
+    // In elements of the corresponding arena
+    struct Capacity
+    {
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t shortIndexCount = 0;
+        uint32_t meshletCount = 0;
+        uint32_t meshletDataCount = 0;
+        uint32_t primitiveCount = 0;
+    };
+
+    SceneGeometry(const Capacity& capacity, const VulkanContext& vulkanContext);
+    ~SceneGeometry();
+
+    SceneGeometry(const SceneGeometry&) = delete;
+    SceneGeometry& operator=(const SceneGeometry&) = delete;
+
+    SceneGeometry(SceneGeometry&&) = delete;
+    SceneGeometry& operator=(SceneGeometry&&) = delete;
+
+    // Uploads all primitives at once with their coarsest lods, returned slots are what gpu::Draw::primitiveIndex
+    // refers to. Slot is invalidSlot if arenas are out of space for the primitive, they don't grow
+    std::vector<uint32_t> AddPrimitives(const RawScene& rawScene, std::span<const uint32_t> primitiveIndices);
+
+    // Makes the next finer lod of each slot resident, slots must not repeat. Stops at the first lod that doesn't fit,
+    // returns how many slots got their lod. Raw scene must be the one the primitives were added from.
+    // Upload is queued, see RecordUploads
+    size_t RefineLods(const RawScene& rawScene, std::span<const uint32_t> slots);
+
+    // Evicts the finest resident lod of each slot, slots must not repeat and must have more than 1 resident lod.
+    // Evicted ranges are reused once frames in flight are done with them. Upload is queued, see RecordUploads
+    void CoarsenLods(std::span<const uint32_t> slots);
+
+    // Copies queued uploads with a single staging buffer ahead of the frame commands, so culling of the frame is the
+    // first one to see the new lods. Call before the frame commands are recorded
+    void RecordUploads(CommandRecorder& recorder);
+
+    // Same as RecordUploads but waits for the copy right away, for scene loading
+    void SubmitUploads();
+
+    // Lods from this one to the coarsest are resident, see gpu::Primitive::finestResidentLod
+    uint32_t GetFinestResidentLod(uint32_t slot) const;
+
+    uint32_t GetSlotCapacity() const
+    {
+        return slotCapacity;
+    }
+
+    // Draws referencing the slot must be gone by now, its ranges are reused once frames in flight are done with them
+    void RemovePrimitive(uint32_t slot);
+
+    // Call only when gpu is done with the frame, see DeletionQueue::Flush
+    void BeginFrame(uint32_t frameIndex);
+
+    const Buffer& GetVertexBuffer() const
+    {
+        return vertices.buffer;
+    }
+
+    const Buffer& GetIndexBuffer() const
+    {
+        return indices.buffer;
+    }
+
+    // Indices of the lods with gpu::Lod::bShortIndices, drawn with VK_INDEX_TYPE_UINT16
+    const Buffer& GetShortIndexBuffer() const
+    {
+        return shortIndices.buffer;
+    }
+
+    const Buffer& GetMeshletBuffer() const
+    {
+        return meshlets.buffer;
+    }
+
+    const Buffer& GetMeshletDataBuffer() const
+    {
+        return meshletData.buffer;
+    }
+
+    const Buffer& GetPrimitiveBuffer() const
+    {
+        return primitiveBuffer;
+    }
+
+    // gpu::maxLodCount lods per primitive slot
+    const Buffer& GetLodBuffer() const
+    {
+        return lodBuffer;
+    }
+
+private:
+    struct Arena
+    {
+        Buffer buffer;
+        OffsetAllocator allocator;
+        uint32_t elementSize = 0;
+
+        VkDeviceSize GetByteOffset(const OffsetAllocator::Allocation allocation) const
+        {
+            return static_cast<VkDeviceSize>(allocation.offset) * elementSize;
+        }
+    };
+
+    struct ResidentLod
+    {
+        Arena* indexArena = nullptr; // 16-bit index arena if the lod has bShortIndices
+        OffsetAllocator::Allocation indices;
+        OffsetAllocator::Allocation meshlets;
+        OffsetAllocator::Allocation meshletData;
+    };
+
+    struct ResidentPrimitive
+    {
+        OffsetAllocator::Allocation vertices;
+        std::array<ResidentLod, gpu::maxLodCount> lods;
+
+        gpu::Primitive primitive; // Patched copy, uploaded again when resident lods change
+        uint32_t primitiveIndex = 0; // In raw scene
+    };
+
+    struct AllocationRequest
+    {
+        Arena* arena = nullptr;
+        OffsetAllocator::Allocation* allocation = nullptr;
+        uint32_t size = 0;
+    };
+
+    struct PendingRelease
+    {
+        Arena* arena = nullptr;
+        OffsetAllocator::Allocation allocation;
+    };
+
+    struct UploadRegion
+    {
+        const Buffer* destination = nullptr;
+        std::span<const std::byte> data;
+        VkDeviceSize offset = 0;
+    };
+
+    // Patched copies are queued straight from here, so the vectors are reserved upfront and must not reallocate
+    struct UploadBatch
+    {
+        std::vector<UploadRegion> regions;
+        std::vector<gpu::Meshlet> meshlets;
+        std::vector<gpu::Lod> lods;
+    };
+
+    struct PendingCopy
+    {
+        const Buffer* destination = nullptr;
+        VkBufferCopy region = {};
+    };
+
+    // Data is copied when queued, primitives are added with their latest state when the staging buffer is filled
+    struct PendingUploads
+    {
+        std::vector<std::byte> data;
+        std::vector<PendingCopy> copies;
+        std::vector<uint32_t> primitiveSlots;
+    };
+
+    uint32_t AllocateSlot();
+
+    // Returns false and allocates nothing if any of the ranges doesn't fit
+    static bool Allocate(std::span<const AllocationRequest> requests);
+
+    // Allocates the lod and adds its patched data to the batch, returns false if it doesn't fit
+    bool AddLod(ResidentPrimitive& resident, uint32_t slot, uint32_t lodIndex, const RawScene& rawScene,
+        UploadBatch& batch);
+
+    // Allocation is freed when the current frame comes around again
+    void ReleaseLater(Arena& arena, OffsetAllocator::Allocation& allocation);
+
+    void QueueUpload(std::span<const UploadRegion> regions);
+    void QueueCopy(const Buffer& destination, std::span<const std::byte> data, VkDeviceSize offset);
+
+    // Takes the pending uploads, staging buffer is invalid if there is nothing to copy
+    std::pair<Buffer, std::vector<PendingCopy>> TakePendingUploads();
+
+    static void RecordCopies(VkCommandBuffer cmd, VkBuffer stagingBuffer, std::span<const PendingCopy> copies);
+
+    const VulkanContext* vulkanContext = nullptr;
+
+    Arena vertices;
+    Arena indices;
+    Arena shortIndices;
+    Arena meshlets;
+    Arena meshletData;
+
+    Buffer primitiveBuffer;
+    Buffer lodBuffer;
+
+    std::vector<ResidentPrimitive> residentPrimitives; // Indexed by slot
+    std::vector<uint32_t> freeSlots;
+    uint32_t slotCapacity = 0;
+
+    PendingUploads pendingUploads;
+
+    std::array<std::vector<PendingRelease>, VulkanConfig::maxFramesInFlight> pendingReleases;
+    std::array<std::vector<uint32_t>, VulkanConfig::maxFramesInFlight> pendingSlots;
+    uint32_t currentFrame = 0;
+};
\ No newline at end of file
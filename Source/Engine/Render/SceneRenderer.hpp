@@ -2,11 +2,13 @@
 
 #include "Engine/Render/Renderer.hpp"
 #include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderOptions.hpp"
 
 class VulkanContext;
 class EventSystem;
 class RenderStage;
 class Scene;
+class LodStreamer;
 
 namespace ES
 {
@@ -15,6 +17,7 @@ namespace ES
     struct TryReloadShaders;
     struct SceneOpened;
     struct SceneClosed;
+    struct BuffersRelocated;
 }
 
 class SceneRenderer : public Renderer
@@ -34,14 +37,33 @@ public:
     void Render(const Frame& frame) override;
 
 private:
+    // Scene commands are recorded once per frame in flight and swapchain image if RenderOptions::GetReuseCommands
+    struct RecordedFrame
+    {
+        Frame frame;
+        uint32_t version = 0;
+    };
+
     void CreateRenderTargets();
     void DestroyRenderTargets();
+    void RecreateFramebuffers();
+
+    // Frame boundary, no commands of the current frame are recorded yet
+    void ApplyReloadedShaders();
+    void ApplySampleCount();
+
+    // Lod streaming needs raw scene geometry, so the option is overridden while streaming
+    RawSceneResidency GetRawResidency() const;
+
+    void ExecuteStages(const Frame& frame) const;
+    const CommandRecorder& GetRecordedCommands(const Frame& frame);
 
     void OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecreated& event);
     void OnSwapchainRecreated(const ES::SwapchainRecreated& event);
     void OnTryReloadShaders(const ES::TryReloadShaders& event);
     void OnSceneOpen(const ES::SceneOpened& event);
     void OnSceneClose(const ES::SceneClosed& event);
+    void OnBuffersRelocated(const ES::BuffersRelocated& event);
 
     const VulkanContext* vulkanContext = nullptr;
 
@@ -50,7 +72,14 @@ private:
     RenderContext renderContext;
 
     std::unique_ptr<RenderStage> primitiveCullStage;
+    std::unique_ptr<RenderStage> drawSortStage;
     std::unique_ptr<RenderStage> forwardStage;
 
+    std::array<std::vector<RecordedFrame>, VulkanConfig::maxFramesInFlight> recordedFrames;
+    std::tuple<GraphicsPipelineType, DrawSortMode, bool, DebugView> recordedOptions = {};
+    uint32_t recordingVersion = 1; // Recorded frames with other version are outdated and get recorded again
+
     Scene* scene = nullptr;
+
+    std::unique_ptr<LodStreamer> lodStreamer; // Only if not all of the scene lods fit in geometry arenas
 };
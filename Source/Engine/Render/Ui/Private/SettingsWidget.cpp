@@ -12,6 +12,17 @@ namespace SettingsWidgetDetails
 
     static bool showDemoWindow = false;
 
+    // Report is done for a fixed resolution so the numbers are comparable between machines
+    constexpr VkDeviceSize reportWidth = 3840;
+    constexpr VkDeviceSize reportHeight = 2160;
+    constexpr VkDeviceSize colorTexelSize = 4; // B8G8R8A8 swapchain format
+    constexpr VkDeviceSize depthTexelSize = 4; // VulkanConfig::depthImageFormat
+
+    static float ToMegabytes(const VkDeviceSize size)
+    {
+        return static_cast<float>(size) / (1024.0f * 1024.0f);
+    }
+
     template <typename T>
     void Combo(const char* label, const std::span<const T> options, std::function<T()> get, std::function<void(T)> set)
     {
@@ -56,6 +67,13 @@ SettingsWidget::SettingsWidget(const VulkanContext& aVulkanContext)
     
     std::ranges::copy_if(OptionValues::graphicsPipelineTypes, std::back_inserter(supportedGraphicsPipelineTypes),
         isGraphicsPipelineTypeSupported);
+
+    const auto isSampleCountSupported = [&](const VkSampleCountFlagBits sampleCount) {
+        return renderOptions->IsSampleCountSupported(sampleCount);
+    };
+
+    std::ranges::copy_if(OptionValues::sampleCounts, std::back_inserter(supportedSampleCounts),
+        isSampleCountSupported);
 }
 
 void SettingsWidget::Process(const Frame& frame, float deltaSeconds)
@@ -86,6 +104,39 @@ void SettingsWidget::Build()
             Combo<GraphicsPipelineType>("Pipeline", supportedGraphicsPipelineTypes,
                 [&]() { return renderOptions->GetGraphicsPipelineType(); },
                 [&](auto type) { renderOptions->SetGraphicsPipelineType(type); });
+
+            Combo<DrawSortMode>("Draw sort", OptionValues::drawSortModes,
+                [&]() { return renderOptions->GetDrawSortMode(); },
+                [&](auto mode) { renderOptions->SetDrawSortMode(mode); });
+
+            Combo<DebugView>("Debug view", OptionValues::debugViews,
+                [&]() { return renderOptions->GetDebugView(); },
+                [&](auto view) { renderOptions->SetDebugView(view); });
+
+            Combo<VkSampleCountFlagBits>("MSAA", supportedSampleCounts,
+                [&]() { return renderOptions->GetSampleCount(); },
+                [&](auto sampleCount) { renderOptions->SetSampleCount(sampleCount); });
+
+            BuildSampleCountReport();
+
+            Combo<RawSceneResidency>("CPU scene data", OptionValues::rawSceneResidencies,
+                [&]() { return renderOptions->GetRawSceneResidency(); },
+                [&](auto residency) { renderOptions->SetRawSceneResidency(residency); });
+
+            bool reuseCommands = renderOptions->GetReuseCommands();
+            if (ImGui::Checkbox("Reuse commands", &reuseCommands))
+            {
+                renderOptions->SetReuseCommands(reuseCommands);
+            }
+        }
+
+        if (renderOptions->IsShaderOptimizationSupported())
+        {
+            bool optimizeShaders = renderOptions->GetOptimizeShaders();
+            if (ImGui::Checkbox("Optimize shaders", &optimizeShaders))
+            {
+                renderOptions->SetOptimizeShaders(optimizeShaders);
+            }
         }
     }
     
@@ -101,3 +152,43 @@ void SettingsWidget::Build()
         ImGui::ShowDemoWindow();
     }
 }
+
+void SettingsWidget::BuildSampleCountReport() const
+{
+    using namespace SettingsWidgetDetails;
+
+    if (!ImGui::TreeNode("MSAA cost at 4K"))
+    {
+        return;
+    }
+
+    const bool lazilyAllocated = vulkanContext->GetDevice().GetProperties().lazilyAllocatedMemorySupported;
+    const VkDeviceSize pixelCount = reportWidth * reportHeight;
+    const VkDeviceSize resolveSize = pixelCount * colorTexelSize;
+
+    for (const VkSampleCountFlagBits sampleCount : supportedSampleCounts)
+    {
+        const VkDeviceSize samples = sampleCount;
+
+        // Without MSAA color goes straight to the swapchain image, only depth target is allocated
+        const VkDeviceSize colorSize = samples > 1 ? pixelCount * samples * colorTexelSize : 0;
+        const VkDeviceSize depthSize = pixelCount * samples * depthTexelSize;
+
+        // Targets are transient with DONT_CARE store, tilers keep them on chip and never commit memory
+        const VkDeviceSize committedSize = lazilyAllocated ? 0 : colorSize + depthSize;
+
+        // Tilers only write the resolved image, immediate gpus also write every sample out at least once
+        const VkDeviceSize minTraffic = resolveSize;
+        const VkDeviceSize maxTraffic = resolveSize + colorSize + depthSize;
+
+        ImGui::Text("%s: %.0f MB targets, %.0f - %.0f MB/frame", UiStrings::ToString(sampleCount).data(),
+            ToMegabytes(committedSize), ToMegabytes(minTraffic), ToMegabytes(maxTraffic));
+    }
+
+    if (lazilyAllocated)
+    {
+        ImGui::TextUnformatted("Targets are lazily allocated");
+    }
+
+    ImGui::TreePop();
+}
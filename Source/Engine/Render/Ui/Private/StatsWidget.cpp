@@ -1,13 +1,32 @@
 #include "Engine/Render/Ui/StatsWidget.hpp"
 
+#include "Engine/EventSystem.hpp"
 #include "Engine/Scene/Scene.hpp"
+#include "Engine/Render/RenderOptions.hpp"
+#include "Engine/Render/Ui/UiStrings.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 
 #include <imgui.h>
 
-StatsWidget::StatsWidget(const VulkanContext& aVulkanContext)
-    : vulkanContext{ &aVulkanContext }
-{}
+namespace StatsWidgetDetails
+{
+    static float ToMegabytes(const VkDeviceSize size)
+    {
+        return static_cast<float>(size) / (1024.0f * 1024.0f);
+    }
+}
+
+StatsWidget::StatsWidget(EventSystem& aEventSystem, const VulkanContext& aVulkanContext)
+    : eventSystem{ &aEventSystem }
+    , vulkanContext{ &aVulkanContext }
+{
+    eventSystem->Subscribe<ES::LodStreamingUpdated>(this, &StatsWidget::OnLodStreamingUpdated);
+}
+
+StatsWidget::~StatsWidget()
+{
+    eventSystem->UnsubscribeAll(this);
+}
 
 void StatsWidget::Process(const Frame& frame, float deltaSeconds)
 {
@@ -15,10 +34,14 @@ void StatsWidget::Process(const Frame& frame, float deltaSeconds)
     frameTimes.back() = deltaSeconds;
 
     triangleCount = frame.stats.triangleCount;
+    gpuTimesMs = frame.stats.gpuTimesMs;
+    memoryStats = vulkanContext->GetMemoryManager().GetStats();
 }
 
 void StatsWidget::Build()
 {
+    using namespace StatsWidgetDetails;
+
     ImGui::SetNextWindowPos({});
 
     ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.3f, 0.3f, 0.3f, 0.7f));
@@ -39,8 +62,51 @@ void StatsWidget::Build()
 
     ImGui::Text("Triangles (total): %.2fM", Scene::GetTotalTriangles() / 1'000'000.0f);
     ImGui::Text("Triangles: %.2fM", triangleCount / 1'000'000.0f);
+
+    ImGui::Text("GPU cull: %.2f ms.", gpuTimesMs[static_cast<size_t>(GpuTimer::eCull)]);
+    ImGui::Text("GPU sort: %.2f ms.", gpuTimesMs[static_cast<size_t>(GpuTimer::eSort)]);
+    ImGui::Text("GPU forward: %.2f ms.", gpuTimesMs[static_cast<size_t>(GpuTimer::eForward)]);
+
+    for (size_t i = 0; i < memoryStats.heaps.size(); ++i)
+    {
+        const MemoryStats::Heap& heap = memoryStats.heaps[i];
+
+        ImGui::Text("Heap %zu (%s): %.0f / %.0f MB", i, heap.deviceLocal ? "device" : "host",
+            ToMegabytes(heap.usage), ToMegabytes(heap.budget));
+    }
+
+    for (size_t i = 0; i < MemoryStats::categoryCount; ++i)
+    {
+        const MemoryStats::Category& category = memoryStats.categories[i];
+
+        if (category.allocationCount > 0)
+        {
+            ImGui::Text("%s: %.1f MB (%u)", UiStrings::ToString(static_cast<MemoryCategory>(i)).data(),
+                ToMegabytes(category.size), category.allocationCount);
+        }
+    }
+
+    ImGui::Text("Allocations: %u, blocks: %u", memoryStats.allocationCount, memoryStats.blockCount);
+
+    // Lod streaming keeps everything regardless of the option, see SceneRenderer::GetRawResidency
+    const RawSceneResidency residency = lodStats.lodCount > 0
+        ? RawSceneResidency::eKeepAll : RenderOptions::Get().GetRawSceneResidency();
+
+    ImGui::Text("Scene CPU data: %.1f MB (%s)", ToMegabytes(Scene::GetRawFootprint()),
+        UiStrings::ToString(residency).data());
+
+    if (lodStats.lodCount > 0)
+    {
+        ImGui::Text("Streamed lods: %u / %u resident, %u pending", lodStats.residentLodCount, lodStats.lodCount,
+            lodStats.pendingLodCount);
+    }
     
     ImGui::End();
 
     ImGui::PopStyleColor();
 }
+
+void StatsWidget::OnLodStreamingUpdated(const ES::LodStreamingUpdated& event)
+{
+    lodStats = event.stats;
+}
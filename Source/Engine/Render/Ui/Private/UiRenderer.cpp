@@ -30,7 +30,8 @@ namespace UiRendererDetails
 
         const BufferDescription bufferDescription = { .size = dataSize,
             .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+            .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            .category = MemoryCategory::eStaging };
 
         return { Buffer(bufferDescription, false, fontDataSpan, vulkanContext), width, height };
     }
@@ -103,13 +104,11 @@ namespace UiRendererDetails
 
     static std::vector<ShaderModule> GetShaderModules(const ShaderManager& shaderManager)
     {
-        std::vector<ShaderModule> shaderModules;
-        shaderModules.reserve(2);
+        constexpr std::array<ShaderDescription, 2> shaderDescriptions = { {
+            { vertexShaderPath, ShaderType::eVertex },
+            { fragmentShaderPath, ShaderType::eFragment } } };
 
-        shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(vertexShaderPath), ShaderType::eVertex));
-        shaderModules.emplace_back(shaderManager.CreateShaderModule(FilePath(fragmentShaderPath), ShaderType::eFragment));
-
-        return shaderModules;
+        return shaderManager.CreateShaderModules(shaderDescriptions);
     }
 
     std::vector<VkVertexInputBindingDescription> GetVertexBindings()
@@ -158,9 +157,10 @@ namespace UiRendererDetails
         return scissor;
     }
 
-    static void CreateWidgets(std::vector<std::unique_ptr<Widget>>& widgets, const VulkanContext& vulkanContext)
+    static void CreateWidgets(std::vector<std::unique_ptr<Widget>>& widgets, EventSystem& eventSystem,
+        const VulkanContext& vulkanContext)
     {
-        widgets.push_back(std::make_unique<StatsWidget>(vulkanContext));
+        widgets.push_back(std::make_unique<StatsWidget>(eventSystem, vulkanContext));
         widgets.push_back(std::make_unique<SettingsWidget>(vulkanContext));
     }
 }
@@ -172,6 +172,7 @@ UiRenderer::UiRenderer(const Window& aWindow, EventSystem& aEventSystem, const V
     , vertexBuffers{ VulkanConfig::maxFramesInFlight }
     , indexBuffers{ VulkanConfig::maxFramesInFlight }
     , inputMode{ window->GetInputMode() }
+    , pipelineReloader{ aVulkanContext }
 {
     using namespace UiRendererDetails;
 
@@ -188,16 +189,17 @@ UiRenderer::UiRenderer(const Window& aWindow, EventSystem& aEventSystem, const V
     framebuffers = CreateFramebuffers(renderPass, *vulkanContext);
     fontTexture = CreateFontTexture(ImGui::GetIO(), *vulkanContext);
 
-    std::tie(descriptor, layout) = vulkanContext->GetDescriptorSetsManager().GetDescriptorSetBuilder()
-        .Bind(0, fontTexture, VK_SHADER_STAGE_FRAGMENT_BIT)
+    layout = vulkanContext->GetDescriptorSetsManager().GetDescriptorSetLayoutBuilder()
+        .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
         .Build();
+    updateTemplate = DescriptorUpdateTemplate(layout, *vulkanContext);
 
     std::vector<ShaderModule> shaderModules = GetShaderModules(vulkanContext->GetShaderManager());
     Assert(std::ranges::all_of(shaderModules, &ShaderModule::IsValid));
 
-    CreateGraphicsPipeline(std::move(shaderModules));
+    graphicsPipeline = CreateGraphicsPipeline(std::move(shaderModules), layout, renderPass, *vulkanContext);
     
-    CreateWidgets(widgets, *vulkanContext);
+    CreateWidgets(widgets, *eventSystem, *vulkanContext);
 
     eventSystem->Subscribe<ES::BeforeSwapchainRecreated>(this, &UiRenderer::OnBeforeSwapchainRecreated);
     eventSystem->Subscribe<ES::SwapchainRecreated>(this, &UiRenderer::OnSwapchainRecreated);
@@ -246,36 +248,54 @@ void UiRenderer::Render(const Frame& frame)
 {
     using namespace VulkanUtils;
 
+    // Frame boundary, nothing is recorded with the old pipeline yet
+    pipelineReloader.TryApply(std::span(&graphicsPipeline, 1));
+
     UpdateBuffers(frame.index);
 
-    const Buffer& vertexBuffer = vertexBuffers[frame.index];
-    const Buffer& indexBuffer = indexBuffers[frame.index];
+    const VkBuffer vertexBuffer = vertexBuffers[frame.index];
+    const VkBuffer indexBuffer = indexBuffers[frame.index];
 
+    const VkFramebuffer framebuffer = framebuffers[frame.swapchainImageIndex];
     const VkExtent2D extent = vulkanContext->GetSwapchain().GetExtent();
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffers[frame.swapchainImageIndex];
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = extent;
-    
-    const VkCommandBuffer commandBuffer = frame.commandBuffer;
+    // UI textures are bound per frame, so the set comes from the transient allocator and is gone with the frame
+    const std::array<DescriptorData, 1> descriptorData = { DescriptorData::FromTexture(fontTexture) };
+    const VkDescriptorSet descriptorSet = vulkanContext->GetDescriptorSetsManager().GetTransientAllocator()
+        .Allocate(updateTemplate, descriptorData);
+
+    frame.recorder->Record([=, this](VkCommandBuffer commandBuffer) {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = framebuffer;
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = extent;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    });
+
+    // Draw data stays valid until the next ImGui::NewFrame and it happens only after the frame is flushed
+    const ImDrawData* drawData = ImGui::GetDrawData();
+    const ImVec2 clipScale = ImGui::GetIO().DisplayFramebufferScale;
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+    frame.recorder->RecordSecondary([=, this](VkCommandBuffer commandBuffer) {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
 
-    const VkViewport viewport = GetViewport(static_cast<float>(extent.width), static_cast<float>(extent.height));
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        const VkViewport viewport = GetViewport(static_cast<float>(extent.width), static_cast<float>(extent.height));
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline.GetLayout(),
-        0, 1, &descriptor, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline.GetLayout(),
+            0, 1, &descriptorSet, 0, nullptr);
     
-    vkCmdPushConstants(commandBuffer, graphicsPipeline.GetLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
-        sizeof(PushConstants), &pushConstants);
+        vkCmdPushConstants(commandBuffer, graphicsPipeline.GetLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
+            sizeof(PushConstants), &pushConstants);
+
+        if (drawData->CmdLists.empty())
+        {
+            return;
+        }
 
-    if (const ImDrawData* drawData = ImGui::GetDrawData(); !drawData->CmdLists.empty())
-    {
         const VkBuffer vkVertexBuffers[] = { vertexBuffer };
         constexpr VkDeviceSize offsets[] = { 0 };
 
@@ -285,7 +305,6 @@ void UiRenderer::Render(const Frame& frame)
         int32_t vertexOffset = 0;
         int32_t indexOffset = 0;
         
-        const ImVec2 clipScale = ImGui::GetIO().DisplayFramebufferScale;
         VkRect2D scissorRect;
 
         const auto issueDraw = [&](const ImDrawCmd& command) {
@@ -303,15 +322,23 @@ void UiRenderer::Render(const Frame& frame)
         };
 
         std::ranges::for_each(drawData->CmdLists, processDrawList);
-    }
+    }, renderPass, framebuffer);
 
-    vkCmdEndRenderPass(commandBuffer);
+    frame.recorder->Record([](VkCommandBuffer commandBuffer) {
+        vkCmdEndRenderPass(commandBuffer);
+    });
 }
 
-void UiRenderer::CreateGraphicsPipeline(std::vector<ShaderModule>&& shaderModules)
+Pipeline UiRenderer::CreateGraphicsPipeline(std::vector<ShaderModule>&& shaderModules,
+    const VkDescriptorSetLayout descriptorSetLayout, const VkRenderPass renderPass, const VulkanContext& vulkanContext)
 {
-    graphicsPipeline = GraphicsPipelineBuilder(*vulkanContext)
-        .SetDescriptorSetLayouts({ layout })
+    if (!std::ranges::all_of(shaderModules, &ShaderModule::IsValid))
+    {
+        return {};
+    }
+
+    return GraphicsPipelineBuilder(vulkanContext)
+        .SetDescriptorSetLayouts({ descriptorSetLayout })
         .AddPushConstantRange({ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants) })
         .SetShaderModules(std::move(shaderModules))
         .SetVertexData(UiRendererDetails::GetVertexBindings(), UiRendererDetails::GetVertexAttributes())
@@ -391,7 +418,7 @@ void UiRenderer::UpdateImGuiInputState() const
 
 void UiRenderer::OnBeforeSwapchainRecreated(const ES::BeforeSwapchainRecreated& event)
 {
-    VulkanUtils::DestroyFramebuffers(framebuffers, *vulkanContext);
+    vulkanContext->GetDeletionQueue().Enqueue(framebuffers);
 }
 
 void UiRenderer::OnSwapchainRecreated(const ES::SwapchainRecreated& event)
@@ -411,11 +438,24 @@ void UiRenderer::OnWindowRecreated(const ES::WindowRecreated& event)
 
 void UiRenderer::OnTryReloadShaders(const ES::TryReloadShaders& event)
 {
-    if (std::vector<ShaderModule> shaderModules = UiRendererDetails::GetShaderModules(vulkanContext->GetShaderManager());
-        std::ranges::all_of(shaderModules, &ShaderModule::IsValid))
+    using namespace UiRendererDetails;
+
+    const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
+
+    if (!shaderManager.IsShaderAffected(FilePath(vertexShaderPath), event.changedFiles) &&
+        !shaderManager.IsShaderAffected(FilePath(fragmentShaderPath), event.changedFiles))
     {
-        CreateGraphicsPipeline(std::move(shaderModules));
+        return;
     }
+
+    pipelineReloader.Start([&context = *vulkanContext, descriptorSetLayout = static_cast<VkDescriptorSetLayout>(layout),
+        vkRenderPass = static_cast<VkRenderPass>(renderPass)]() {
+        PipelineReloader::KeyedPipelines pipelines;
+        pipelines.emplace_back(0, CreateGraphicsPipeline(
+            GetShaderModules(context.GetShaderManager()), descriptorSetLayout, vkRenderPass, context));
+
+        return pipelines;
+    });
 }
 
 void UiRenderer::OnBeforeInputModeUpdated(const ES::BeforeInputModeUpdated& event)
@@ -14,10 +14,13 @@ public:
     void Build() override;
     
 private:
+    void BuildSampleCountReport() const;
+
 DISABLE_WARNINGS_BEGIN
     const VulkanContext* vulkanContext = nullptr;
 DISABLE_WARNINGS_END
     
     RenderOptions* renderOptions = nullptr;
     std::vector<GraphicsPipelineType> supportedGraphicsPipelineTypes;
+    std::vector<VkSampleCountFlagBits> supportedSampleCounts;
 };
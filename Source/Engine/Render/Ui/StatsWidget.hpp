@@ -1,13 +1,28 @@
 #pragma once
 
+#include "Engine/Render/LodStreamer.hpp"
 #include "Engine/Render/Ui/Widget.hpp"
+#include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
+
+namespace ES
+{
+    struct LodStreamingUpdated;
+}
 
 class VulkanContext;
+class EventSystem;
 
 class StatsWidget : public Widget
 {
 public:
-    StatsWidget(const VulkanContext& vulkanContext);
+    StatsWidget(EventSystem& eventSystem, const VulkanContext& vulkanContext);
+    ~StatsWidget() override;
+
+    StatsWidget(const StatsWidget&) = delete;
+    StatsWidget& operator=(const StatsWidget&) = delete;
+
+    StatsWidget(StatsWidget&&) = delete;
+    StatsWidget& operator=(StatsWidget&&) = delete;
     
     void Process(const Frame& frame, float deltaSeconds) override;
     void Build() override;
@@ -18,8 +33,14 @@ public:
     }
     
 private:
+    void OnLodStreamingUpdated(const ES::LodStreamingUpdated& event);
+
+    EventSystem* eventSystem = nullptr;
     const VulkanContext* vulkanContext = nullptr;
     
     std::array<float, 50> frameTimes = {};
     uint64_t triangleCount = 0;
+    std::array<float, GpuTimers::timerCount> gpuTimesMs = {};
+    MemoryStats memoryStats;
+    LodStreamer::Stats lodStats;
 };
@@ -9,8 +9,10 @@
 #include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
 #include "Engine/Render/Vulkan/Image/Texture.hpp"
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderModule.hpp"
 #include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorUpdateTemplate.hpp"
 
 class VulkanContext;
 class EventSystem;
@@ -50,7 +52,9 @@ public:
     void Render(const Frame& frame) override;
 
 private:
-    void CreateGraphicsPipeline(std::vector<ShaderModule>&& shaderModules);
+    // Static, so reload builds only use what they were given, see PipelineReloader::Start
+    static Pipeline CreateGraphicsPipeline(std::vector<ShaderModule>&& shaderModules,
+        VkDescriptorSetLayout descriptorSetLayout, VkRenderPass renderPass, const VulkanContext& vulkanContext);
     
     void UpdateBuffers(uint32_t frameIndex);
     
@@ -79,12 +83,14 @@ private:
 
     Texture fontTexture;
 
-    VkDescriptorSet descriptor = VK_NULL_HANDLE;
     DescriptorSetLayout layout;
+    DescriptorUpdateTemplate updateTemplate;
 
     PushConstants pushConstants;
 
     InputMode inputMode = InputMode::eEngine;
     
     std::vector<std::unique_ptr<Widget>> widgets;
+
+    PipelineReloader pipelineReloader;
 };
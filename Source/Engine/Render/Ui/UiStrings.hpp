@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Render/RenderOptions.hpp"
+#include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
 
 namespace UiStrings
 {
@@ -32,4 +33,80 @@ namespace UiStrings
         
         return placeholder;
     }
+
+    template <>
+    constexpr std::string_view ToString<DrawSortMode>(DrawSortMode drawSortMode)
+    {
+        switch (drawSortMode)
+        {
+            case DrawSortMode::eNone: return "None";
+            case DrawSortMode::eDepth: return "Depth";
+            case DrawSortMode::eState: return "State";
+            case DrawSortMode::eStateDepth: return "State + depth";
+        }
+        
+        return placeholder;
+    }
+
+    template <>
+    constexpr std::string_view ToString<DebugView>(DebugView debugView)
+    {
+        switch (debugView)
+        {
+            case DebugView::eNone: return "None";
+            case DebugView::eMeshlets: return "Meshlets";
+            case DebugView::eLods: return "LODs";
+        }
+        
+        return placeholder;
+    }
+
+    template <>
+    constexpr std::string_view ToString<VkSampleCountFlagBits>(VkSampleCountFlagBits sampleCount)
+    {
+        switch (sampleCount)
+        {
+            case VK_SAMPLE_COUNT_1_BIT: return "Off";
+            case VK_SAMPLE_COUNT_2_BIT: return "2x";
+            case VK_SAMPLE_COUNT_4_BIT: return "4x";
+            case VK_SAMPLE_COUNT_8_BIT: return "8x";
+            case VK_SAMPLE_COUNT_16_BIT: return "16x";
+            case VK_SAMPLE_COUNT_32_BIT: return "32x";
+            case VK_SAMPLE_COUNT_64_BIT: return "64x";
+            default: break;
+        }
+        
+        return placeholder;
+    }
+
+    template <>
+    constexpr std::string_view ToString<RawSceneResidency>(RawSceneResidency rawSceneResidency)
+    {
+        switch (rawSceneResidency)
+        {
+            case RawSceneResidency::eKeepAll: return "Keep all";
+            case RawSceneResidency::eKeepMetadata: return "Keep metadata";
+            case RawSceneResidency::eReload: return "Reload";
+        }
+        
+        return placeholder;
+    }
+
+    template <>
+    constexpr std::string_view ToString<MemoryCategory>(MemoryCategory memoryCategory)
+    {
+        switch (memoryCategory)
+        {
+            case MemoryCategory::eOther: return "Other";
+            case MemoryCategory::eGeometry: return "Geometry";
+            case MemoryCategory::eDraws: return "Draws";
+            case MemoryCategory::eCommands: return "Commands";
+            case MemoryCategory::eRenderTargets: return "Render targets";
+            case MemoryCategory::eTextures: return "Textures";
+            case MemoryCategory::eStaging: return "Staging";
+            case MemoryCategory::eCount: break;
+        }
+        
+        return placeholder;
+    }
 }
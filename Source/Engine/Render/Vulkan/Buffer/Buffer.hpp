@@ -2,6 +2,8 @@
 
 #include <volk.h>
 
+#include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
+
 class VulkanContext;
 
 struct BufferDescription
@@ -9,6 +11,7 @@ struct BufferDescription
     VkDeviceSize size = 0;
     VkBufferUsageFlags usage = {};
     VkMemoryPropertyFlags memoryProperties = {};
+    MemoryCategory category = MemoryCategory::eOther;
 };
 
 class Buffer
@@ -39,12 +42,23 @@ public:
 
     std::span<std::byte> MapMemory();
     void UnmapMemory();
+
+    // Defragmentation binds a new buffer to the moved allocation, returns the old one for it to destroy
+    VkBuffer ReplaceHandle(VkBuffer newBuffer);
+
+    // Requires VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, shaders access the buffer through it as buffer reference
+    VkDeviceAddress GetDeviceAddress() const;
     
     const BufferDescription& GetDescription() const
     {
         return description;
     }
 
+    VmaAllocation GetAllocation() const
+    {
+        return allocation;
+    }
+
     bool HasStagingBuffer() const
     {
         return stagingBuffer != nullptr;
@@ -71,6 +85,7 @@ private:
     const VulkanContext* vulkanContext = nullptr;
 
     VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
 
     BufferDescription description = {};
 
@@ -4,7 +4,8 @@
 
 namespace BufferDetails
 {
-    static VkBuffer CreateBuffer(const BufferDescription& description, const VulkanContext& vulkanContext)
+    static std::pair<VkBuffer, VmaAllocation> CreateBuffer(const BufferDescription& description,
+        const VulkanContext& vulkanContext)
     {
         Assert(description.size != 0);
 
@@ -16,15 +17,17 @@ namespace BufferDetails
         bufferInfo.queueFamilyIndexCount = 1;
         bufferInfo.pQueueFamilyIndices = &vulkanContext.GetDevice().GetQueues().familyIndices.graphicsAndComputeFamily;
 
-        return vulkanContext.GetMemoryManager().CreateBuffer(bufferInfo, description.memoryProperties);
+        return vulkanContext.GetMemoryManager().CreateBuffer(bufferInfo, description.memoryProperties,
+            description.category);
     }
 }
 
 Buffer::Buffer(BufferDescription aDescription, const bool createStagingBuffer, const VulkanContext& aVulkanContext)
     : vulkanContext{ &aVulkanContext }
-    , buffer{ BufferDetails::CreateBuffer(aDescription, aVulkanContext) }
     , description{ std::move(aDescription) }
 {
+    std::tie(buffer, allocation) = BufferDetails::CreateBuffer(description, *vulkanContext);
+
     if (createStagingBuffer)
     {
         CreateStagingBuffer();
@@ -48,17 +51,19 @@ Buffer::~Buffer()
 
     if (!mappedMemory.empty())
     {
-        vulkanContext->GetMemoryManager().UnmapBufferMemory(buffer);
+        vulkanContext->GetMemoryManager().UnmapMemory(allocation);
         mappedMemory = {};
     }
 
-    vulkanContext->GetMemoryManager().DestroyBuffer(buffer);
+    vulkanContext->GetMemoryManager().DestroyBuffer(buffer, allocation);
     buffer = VK_NULL_HANDLE;
+    allocation = VK_NULL_HANDLE;
 }
 
 Buffer::Buffer(Buffer&& other) noexcept
     : vulkanContext{ other.vulkanContext }
     , buffer{ other.buffer }
+    , allocation{ other.allocation }
     , description{ other.description }
     , mappedMemory{ other.mappedMemory }
     , stagingBuffer{ std::move(other.stagingBuffer) }
@@ -66,6 +71,7 @@ Buffer::Buffer(Buffer&& other) noexcept
     other.vulkanContext = nullptr;
     other.description = {};
     other.buffer = VK_NULL_HANDLE;
+    other.allocation = VK_NULL_HANDLE;
     other.mappedMemory = {};
     other.stagingBuffer = {};
 }
@@ -76,6 +82,7 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept
     {
         std::swap(vulkanContext, other.vulkanContext);
         std::swap(buffer, other.buffer);
+        std::swap(allocation, other.allocation);
         std::swap(description, other.description);
         std::swap(mappedMemory, other.mappedMemory);
         std::swap(stagingBuffer, other.stagingBuffer);
@@ -91,7 +98,8 @@ Buffer& Buffer::CreateStagingBuffer()
     BufferDescription stagingBufferDescription = {
         .size = description.size,
         .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+        .memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        .category = MemoryCategory::eStaging };
 
     stagingBuffer = std::make_unique<Buffer>(stagingBufferDescription, false, *vulkanContext);
 
@@ -112,7 +120,7 @@ std::span<std::byte> Buffer::MapMemory()
 
     if (mappedMemory.empty())
     {
-        void* mappedMemoryPointer = vulkanContext->GetMemoryManager().MapBufferMemory(buffer);
+        void* mappedMemoryPointer = vulkanContext->GetMemoryManager().MapMemory(allocation);
         mappedMemory = { static_cast<std::byte*>(mappedMemoryPointer), description.size };
     }
 
@@ -123,13 +131,38 @@ void Buffer::UnmapMemory()
 {
     Assert(!mappedMemory.empty());
 
-    vulkanContext->GetMemoryManager().UnmapBufferMemory(buffer);
+    vulkanContext->GetMemoryManager().UnmapMemory(allocation);
     mappedMemory = {};
 }
 
+VkBuffer Buffer::ReplaceHandle(const VkBuffer newBuffer)
+{
+    Assert(IsValid() && newBuffer != VK_NULL_HANDLE);
+
+    return std::exchange(buffer, newBuffer);
+}
+
+VkDeviceAddress Buffer::GetDeviceAddress() const
+{
+    Assert(description.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+
+    const VkBufferDeviceAddressInfo addressInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer };
+
+    return vkGetBufferDeviceAddress(vulkanContext->GetDevice(), &addressInfo);
+}
+
 void Buffer::FillImpl(const std::span<const std::byte> data, const size_t offset /* = 0 */)
 {
     Assert(!data.empty() && (data.size() + offset <= description.size));
 
-    vulkanContext->GetMemoryManager().CopyMemoryToBuffer(buffer, data, offset);
+    // Mapped memory is written directly, VMA would map and unmap the allocation otherwise
+    if (!mappedMemory.empty())
+    {
+        std::ranges::copy(data, mappedMemory.begin() + static_cast<ptrdiff_t>(offset));
+        return;
+    }
+
+    vulkanContext->GetMemoryManager().CopyMemoryToAllocation(allocation, data, offset);
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <volk.h>
+
+#include <future>
+
+#include "Engine/Render/Vulkan/VulkanUtils.hpp"
+
+class VulkanContext;
+
+// Collects frame commands in submission order, primary commands are recorded on Flush on the calling thread,
+// secondary ones start recording right away on a worker thread. Every worker gets its own command pool
+// since pools can't be accessed from multiple threads simultaneously.
+// Reusable recorder keeps its commands after Replay, so they can be appended to the frame recorder every frame
+// until the next Reset, see SceneRenderer
+class CommandRecorder
+{
+public:
+    CommandRecorder(VkQueryPipelineStatisticFlags aInheritedStatistics, bool aReusable,
+        const VulkanContext& aVulkanContext);
+    ~CommandRecorder();
+
+    CommandRecorder(const CommandRecorder&) = delete;
+    CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+    CommandRecorder(CommandRecorder&&) = delete;
+    CommandRecorder& operator=(CommandRecorder&&) = delete;
+
+    // Gpu has to be done with previously flushed commands
+    void Reset();
+
+    void Record(DeviceCommands commands);
+
+    // Pass render pass and framebuffer if commands are going to be executed inside of the render pass instance,
+    // in that case the pass itself has to be started with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+    void RecordSecondary(DeviceCommands commands, VkRenderPass renderPass = VK_NULL_HANDLE,
+        VkFramebuffer framebuffer = VK_NULL_HANDLE);
+
+    // Recorder has to outlive the flush of this one
+    void Append(const CommandRecorder& recorder);
+
+    void Flush(VkCommandBuffer commandBuffer);
+    void Replay(VkCommandBuffer commandBuffer) const;
+
+    VkQueryPipelineStatisticFlags GetInheritedStatistics() const
+    {
+        return inheritedStatistics;
+    }
+
+private:
+    struct Worker
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        std::future<void> recording;
+    };
+
+    const VulkanContext* vulkanContext = nullptr;
+
+    VkQueryPipelineStatisticFlags inheritedStatistics = 0;
+    bool reusable = false;
+
+    std::vector<DeviceCommands> commands;
+
+    std::vector<Worker> workers;
+    uint32_t usedWorkersCount = 0;
+};
\ No newline at end of file
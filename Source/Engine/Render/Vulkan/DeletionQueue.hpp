@@ -1,32 +1,63 @@
-// Finish when i really need this one - destroy resources w/o RAII withing the frame (per frame)
-
-//#pragma once
-//
-//#include <volk.h>
-//
-//#include "Engine/Render/Vulkan/Image/Image.hpp"
-//
-//class VulkanContext;
-//
-//class DeletionQueue
-//{
-//public:
-//    DeletionQueue(const VulkanContext& vulkanContext);
-//    ~DeletionQueue();
-//    
-//    DeletionQueue(const DeletionQueue&) = delete;
-//    DeletionQueue& operator=(const DeletionQueue&) = delete;
-//
-//    DeletionQueue(DeletionQueue&& other) noexcept;
-//    DeletionQueue& operator=(DeletionQueue&& other) noexcept;
-//    
-//    void Flush();
-//    
-//    // Const ref? I don't need to move actually.............
-//    void Add(Image image);
-//    
-//private:
-//    const VulkanContext* vulkanContext = nullptr;
-//    
-//    std::vector<Image> images;
-//};
+#pragma once
+
+#include <volk.h>
+
+#include "Engine/Render/Vulkan/RenderPass.hpp"
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
+#include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
+#include "Engine/Render/Vulkan/Image/RenderTarget.hpp"
+#include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetPool.hpp"
+
+class VulkanContext;
+
+// Resources enqueued while frame N is current get destroyed only when the render system gets back to the frame N,
+// that happens after waiting for its previous submission so nothing in flight can reference them anymore
+class DeletionQueue
+{
+public:
+    DeletionQueue(const VulkanContext& aVulkanContext);
+    ~DeletionQueue();
+    
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    DeletionQueue(DeletionQueue&&) = delete;
+    DeletionQueue& operator=(DeletionQueue&&) = delete;
+    
+    // Call only when gpu is done with the frame, destroys resources enqueued the last time frame was current
+    void Flush(uint32_t frameIndex);
+
+    void Enqueue(Buffer&& buffer);
+    void Enqueue(Image&& image);
+    void Enqueue(ImageView&& imageView);
+    void Enqueue(RenderTarget&& renderTarget);
+    void Enqueue(Pipeline&& pipeline);
+    void Enqueue(RenderPass&& renderPass);
+    void Enqueue(DescriptorSetPool&& pool);
+    void Enqueue(VkBuffer buffer); // Bare handle without its own memory, e.g. one that aliased a moved allocation
+    void Enqueue(VkFramebuffer framebuffer);
+    void Enqueue(std::vector<VkFramebuffer>& framebuffers);
+    void Enqueue(VkSwapchainKHR swapchain);
+    
+private:
+    struct FrameResources
+    {
+        std::vector<Buffer> buffers;
+        std::vector<Image> images;
+        std::vector<ImageView> imageViews;
+        std::vector<Pipeline> pipelines;
+        std::vector<RenderPass> renderPasses;
+        std::vector<DescriptorSetPool> descriptorPools;
+        std::vector<VkBuffer> bufferHandles;
+        std::vector<VkFramebuffer> framebuffers;
+        std::vector<VkSwapchainKHR> swapchains;
+    };
+
+    void Destroy(FrameResources& resources) const;
+
+    const VulkanContext* vulkanContext = nullptr;
+
+    std::array<FrameResources, VulkanConfig::maxFramesInFlight> frameResources;
+    uint32_t currentFrame = 0;
+};
\ No newline at end of file
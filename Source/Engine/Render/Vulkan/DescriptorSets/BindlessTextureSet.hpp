@@ -0,0 +1,60 @@
+#pragma once
+
+#include <volk.h>
+
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
+
+class VulkanContext;
+struct Texture;
+
+// Single descriptor indexed array of all scene textures, shaders access them by index from gpu data
+// instead of binding a set per material. Bound as set 0 of all scene pipelines, see Common.h.
+// Partially bound, so slots that are never sampled (unused or holding destroyed textures) don't have to be valid
+class BindlessTextureSet
+{
+public:
+    explicit BindlessTextureSet(const VulkanContext& vulkanContext);
+    ~BindlessTextureSet();
+
+    BindlessTextureSet(const BindlessTextureSet&) = delete;
+    BindlessTextureSet& operator=(const BindlessTextureSet&) = delete;
+
+    BindlessTextureSet(BindlessTextureSet&&) = delete;
+    BindlessTextureSet& operator=(BindlessTextureSet&&) = delete;
+
+    // Call only when gpu is done with the frame, slots removed the last time frame was current become free again
+    void BeginFrame(uint32_t frameIndex);
+
+    // Returns index of the texture in the array, texture must stay alive until it's removed
+    uint32_t Add(const Texture& texture);
+
+    // Frames in flight might still sample the slot, so it's reused only maxFramesInFlight frames later
+    void Remove(uint32_t index);
+
+    // Removes all of the added textures
+    void Reset();
+
+    VkDescriptorSetLayout GetLayout() const
+    {
+        return layout;
+    }
+
+    VkDescriptorSet GetDescriptorSet() const
+    {
+        return descriptorSet;
+    }
+
+private:
+    const VulkanContext* vulkanContext = nullptr;
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    uint32_t textureCount = 0; // Slots past it were never used
+    std::vector<uint32_t> usedSlots;
+    std::vector<uint32_t> freeSlots;
+
+    std::array<std::vector<uint32_t>, VulkanConfig::maxFramesInFlight> removedSlots;
+    uint32_t currentFrame = 0;
+};
\ No newline at end of file
@@ -23,8 +23,12 @@ public:
     DescriptorSetAllocator(DescriptorSetAllocator&& other) noexcept;
     DescriptorSetAllocator& operator=(DescriptorSetAllocator&& other) noexcept;
 
+    // Call only when gpu is done with the frame, pools retired while frame was current become free again
+    void BeginFrame(uint32_t frameIndex);
+
     VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
 
+    // Sets stay valid until frames in flight are done with them, then their pools are reset and reused
     void ResetPools();
 
 private:
@@ -39,4 +43,7 @@ private:
 
     std::vector<std::unique_ptr<DescriptorSetPool>> usedPools;
     std::vector<std::unique_ptr<DescriptorSetPool>> freePools;
+
+    std::array<std::vector<std::unique_ptr<DescriptorSetPool>>, VulkanConfig::maxFramesInFlight> retiredPools;
+    uint32_t currentFrame = 0;
 };
\ No newline at end of file
@@ -10,6 +10,8 @@ public:
 
     const VkDescriptorSetLayoutBinding& GetBinding(uint32_t index) const;
 
+    std::span<const VkDescriptorSetLayoutBinding> GetBindings() const;
+
     bool IsValid() const
     {
         return layout != VK_NULL_HANDLE;
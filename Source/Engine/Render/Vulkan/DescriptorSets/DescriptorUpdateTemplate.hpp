@@ -0,0 +1,55 @@
+#pragma once
+
+#include <volk.h>
+
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayout.hpp"
+
+class VulkanContext;
+class Buffer;
+struct Texture;
+
+// One element per descriptor, see DescriptorUpdateTemplate
+union DescriptorData
+{
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+
+    static DescriptorData FromTexture(const Texture& texture);
+    static DescriptorData FromBuffer(const Buffer& buffer);
+};
+
+// Writes the whole set with a single call from a packed array of DescriptorData, descriptors go in the layout bindings
+// order. Avoids building VkWriteDescriptorSet arrays for sets which are written every frame
+class DescriptorUpdateTemplate
+{
+public:
+    DescriptorUpdateTemplate() = default;
+    DescriptorUpdateTemplate(const DescriptorSetLayout& layout, const VulkanContext& vulkanContext);
+    ~DescriptorUpdateTemplate();
+
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate&) = delete;
+    DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate&) = delete;
+
+    DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept;
+    DescriptorUpdateTemplate& operator=(DescriptorUpdateTemplate&& other) noexcept;
+
+    void Update(VkDescriptorSet descriptorSet, std::span<const DescriptorData> data) const;
+
+    VkDescriptorSetLayout GetLayout() const
+    {
+        return layout;
+    }
+
+    bool IsValid() const
+    {
+        return updateTemplate != VK_NULL_HANDLE;
+    }
+
+private:
+    const VulkanContext* vulkanContext = nullptr;
+
+    VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+
+    uint32_t descriptorCount = 0;
+};
\ No newline at end of file
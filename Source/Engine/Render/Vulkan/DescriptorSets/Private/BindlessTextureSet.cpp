@@ -0,0 +1,151 @@
+#include "Engine/Render/Vulkan/DescriptorSets/BindlessTextureSet.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Image/Texture.hpp"
+
+namespace BindlessTextureSetDetails
+{
+    static VkDescriptorSetLayout CreateLayout(const VulkanContext& vulkanContext)
+    {
+        // Partially bound, so only the used part of the array has to be valid
+        constexpr VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+        const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindingFlags = &bindingFlags };
+
+        const VkDescriptorSetLayoutBinding binding = {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = VulkanConfig::maxBindlessTextures,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT };
+
+        const VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = &bindingFlagsInfo,
+            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .bindingCount = 1,
+            .pBindings = &binding };
+
+        VkDescriptorSetLayout layout;
+        const VkResult result = vkCreateDescriptorSetLayout(vulkanContext.GetDevice(), &layoutInfo, nullptr, &layout);
+        Assert(result == VK_SUCCESS);
+
+        return layout;
+    }
+
+    static VkDescriptorPool CreatePool(const VulkanContext& vulkanContext)
+    {
+        const VkDescriptorPoolSize poolSize = {
+            .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = VulkanConfig::maxBindlessTextures };
+
+        const VkDescriptorPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets = 1,
+            .poolSizeCount = 1,
+            .pPoolSizes = &poolSize };
+
+        VkDescriptorPool pool;
+        const VkResult result = vkCreateDescriptorPool(vulkanContext.GetDevice(), &poolInfo, nullptr, &pool);
+        Assert(result == VK_SUCCESS);
+
+        return pool;
+    }
+
+    static void WriteDescriptor(const VkDescriptorSet descriptorSet, const Texture& texture, const uint32_t index,
+        const VulkanContext& vulkanContext)
+    {
+        // For binding textures we always consider that they're in read-only optimal layout
+        const VkDescriptorImageInfo imageInfo = {
+            .sampler = texture.sampler,
+            .imageView = texture.view,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+        const VkWriteDescriptorSet write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo = &imageInfo };
+
+        vkUpdateDescriptorSets(vulkanContext.GetDevice(), 1, &write, 0, nullptr);
+    }
+}
+
+BindlessTextureSet::BindlessTextureSet(const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+{
+    using namespace BindlessTextureSetDetails;
+
+    layout = CreateLayout(*vulkanContext);
+    pool = CreatePool(*vulkanContext);
+
+    const VkDescriptorSetAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout };
+
+    const VkResult result = vkAllocateDescriptorSets(vulkanContext->GetDevice(), &allocateInfo, &descriptorSet);
+    Assert(result == VK_SUCCESS);
+}
+
+BindlessTextureSet::~BindlessTextureSet()
+{
+    vkDestroyDescriptorPool(vulkanContext->GetDevice(), pool, nullptr);
+    vkDestroyDescriptorSetLayout(vulkanContext->GetDevice(), layout, nullptr);
+}
+
+void BindlessTextureSet::BeginFrame(const uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    std::ranges::copy(removedSlots[currentFrame], std::back_inserter(freeSlots));
+    removedSlots[currentFrame].clear();
+}
+
+uint32_t BindlessTextureSet::Add(const Texture& texture)
+{
+    using namespace BindlessTextureSetDetails;
+
+    uint32_t index = textureCount;
+
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        Assert(textureCount < VulkanConfig::maxBindlessTextures);
+        ++textureCount;
+    }
+
+    // Slot isn't used by any frame in flight, so it's fine to update it while the set is bound
+    WriteDescriptor(descriptorSet, texture, index, *vulkanContext);
+
+    usedSlots.push_back(index);
+
+    return index;
+}
+
+void BindlessTextureSet::Remove(const uint32_t index)
+{
+    const auto it = std::ranges::find(usedSlots, index);
+    Assert(it != usedSlots.end());
+
+    usedSlots.erase(it);
+    removedSlots[currentFrame].push_back(index);
+}
+
+void BindlessTextureSet::Reset()
+{
+    std::ranges::copy(usedSlots, std::back_inserter(removedSlots[currentFrame]));
+    usedSlots.clear();
+}
\ No newline at end of file
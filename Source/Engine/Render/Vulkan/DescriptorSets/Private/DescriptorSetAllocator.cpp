@@ -19,6 +19,8 @@ DescriptorSetAllocator::DescriptorSetAllocator(DescriptorSetAllocator&& other) n
     , currentPool{other.currentPool}
     , usedPools{std::move(other.usedPools)}
     , freePools{std::move(other.freePools)}
+    , retiredPools{std::move(other.retiredPools)}
+    , currentFrame{other.currentFrame}
 {
     other.vulkanContext = nullptr;
     other.currentPool = nullptr;
@@ -36,10 +38,23 @@ DescriptorSetAllocator& DescriptorSetAllocator::operator=(DescriptorSetAllocator
         std::swap(currentPool, other.currentPool);
         std::swap(usedPools, other.usedPools);
         std::swap(freePools, other.freePools);
+        std::swap(retiredPools, other.retiredPools);
+        std::swap(currentFrame, other.currentFrame);
     }
     return *this;
 }
 
+void DescriptorSetAllocator::BeginFrame(const uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    std::vector<std::unique_ptr<DescriptorSetPool>>& pools = retiredPools[currentFrame];
+
+    std::ranges::for_each(pools, [](const std::unique_ptr<DescriptorSetPool>& pool) { pool->Reset(); });
+    std::ranges::move(pools, std::back_inserter(freePools));
+    pools.clear();
+}
+
 VkDescriptorSet DescriptorSetAllocator::Allocate(const VkDescriptorSetLayout layout)
 {
     if (!currentPool)
@@ -67,11 +82,10 @@ VkDescriptorSet DescriptorSetAllocator::Allocate(const VkDescriptorSetLayout lay
 
 void DescriptorSetAllocator::ResetPools()
 {
-    std::ranges::move(usedPools, std::back_inserter(freePools));
+    // Sets from used pools might still be bound by frames in flight, so these pools are reset in BeginFrame
+    std::ranges::move(usedPools, std::back_inserter(retiredPools[currentFrame]));
     usedPools.clear();
 
-    std::ranges::for_each(freePools, [](const std::unique_ptr<DescriptorSetPool>& pool) { pool->Reset(); });
-
     currentPool = nullptr;
 }
 
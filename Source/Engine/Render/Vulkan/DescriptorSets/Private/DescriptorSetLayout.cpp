@@ -15,4 +15,10 @@ const VkDescriptorSetLayoutBinding& DescriptorSetLayout::GetBinding(const uint32
 {
     Assert(IsValid());
     return VulkanUtils::GetBinding(*bindings, index);
+}
+
+std::span<const VkDescriptorSetLayoutBinding> DescriptorSetLayout::GetBindings() const
+{
+    Assert(IsValid());
+    return *bindings;
 }
\ No newline at end of file
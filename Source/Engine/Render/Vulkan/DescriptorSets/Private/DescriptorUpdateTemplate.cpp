@@ -0,0 +1,90 @@
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorUpdateTemplate.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
+#include "Engine/Render/Vulkan/Image/Texture.hpp"
+
+DescriptorData DescriptorData::FromTexture(const Texture& texture)
+{
+    // For binding textures we always consider that they're in read-only optimal layout
+    return { .image = { texture.sampler, texture.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL } };
+}
+
+DescriptorData DescriptorData::FromBuffer(const Buffer& buffer)
+{
+    return { .buffer = { buffer, 0, buffer.GetDescription().size } };
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const DescriptorSetLayout& aLayout,
+    const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+    , layout{ aLayout }
+{
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+
+    for (const VkDescriptorSetLayoutBinding& binding : aLayout.GetBindings())
+    {
+        entries.push_back({
+            .dstBinding = binding.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = binding.descriptorCount,
+            .descriptorType = binding.descriptorType,
+            .offset = descriptorCount * sizeof(DescriptorData),
+            .stride = sizeof(DescriptorData) });
+
+        descriptorCount += binding.descriptorCount;
+    }
+
+    const VkDescriptorUpdateTemplateCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+        .descriptorSetLayout = layout };
+
+    const VkResult result = vkCreateDescriptorUpdateTemplate(vulkanContext->GetDevice(), &createInfo, nullptr,
+        &updateTemplate);
+    Assert(result == VK_SUCCESS);
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate()
+{
+    if (updateTemplate != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorUpdateTemplate(vulkanContext->GetDevice(), updateTemplate, nullptr);
+    }
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept
+    : vulkanContext{ other.vulkanContext }
+    , updateTemplate{ other.updateTemplate }
+    , layout{ other.layout }
+    , descriptorCount{ other.descriptorCount }
+{
+    other.vulkanContext = nullptr;
+    other.updateTemplate = VK_NULL_HANDLE;
+    other.layout = VK_NULL_HANDLE;
+    other.descriptorCount = 0;
+}
+
+DescriptorUpdateTemplate& DescriptorUpdateTemplate::operator=(DescriptorUpdateTemplate&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(vulkanContext, other.vulkanContext);
+        std::swap(updateTemplate, other.updateTemplate);
+        std::swap(layout, other.layout);
+        std::swap(descriptorCount, other.descriptorCount);
+    }
+
+    return *this;
+}
+
+void DescriptorUpdateTemplate::Update(const VkDescriptorSet descriptorSet,
+    const std::span<const DescriptorData> data) const
+{
+    Assert(IsValid());
+    Assert(data.size() == descriptorCount);
+
+    vkUpdateDescriptorSetWithTemplate(vulkanContext->GetDevice(), descriptorSet, updateTemplate, data.data());
+}
\ No newline at end of file
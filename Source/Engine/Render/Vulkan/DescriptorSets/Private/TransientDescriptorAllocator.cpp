@@ -0,0 +1,60 @@
+#include "Engine/Render/Vulkan/DescriptorSets/TransientDescriptorAllocator.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+TransientDescriptorAllocator::TransientDescriptorAllocator(const uint32_t aMaxSetsInPool,
+    const std::span<const SizeRatio> aPoolRatios, const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+    , maxSetsInPool{ aMaxSetsInPool }
+    , poolRatios{ aPoolRatios.begin(), aPoolRatios.end() }
+{}
+
+TransientDescriptorAllocator::~TransientDescriptorAllocator() = default;
+
+void TransientDescriptorAllocator::BeginFrame(const uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    FramePools& frame = framePools[currentFrame];
+
+    // Pools are kept, so after a few frames the ring is large enough and nothing gets created anymore
+    std::ranges::for_each(frame.pools, &DescriptorSetPool::Reset);
+    frame.currentPool = 0;
+}
+
+VkDescriptorSet TransientDescriptorAllocator::Allocate(const VkDescriptorSetLayout layout)
+{
+    FramePools& frame = framePools[currentFrame];
+
+    while (frame.currentPool < frame.pools.size())
+    {
+        const auto [result, set] = frame.pools[frame.currentPool].Allocate(layout);
+
+        if (result == VK_SUCCESS)
+        {
+            return set;
+        }
+
+        // Same as in DescriptorSetAllocator, other errors mean some major issues
+        Assert(result == VK_ERROR_FRAGMENTED_POOL || result == VK_ERROR_OUT_OF_POOL_MEMORY);
+
+        ++frame.currentPool;
+    }
+
+    frame.pools.emplace_back(maxSetsInPool, poolRatios, *vulkanContext);
+
+    const auto [result, set] = frame.pools.back().Allocate(layout);
+    Assert(result == VK_SUCCESS);
+
+    return set;
+}
+
+VkDescriptorSet TransientDescriptorAllocator::Allocate(const DescriptorUpdateTemplate& updateTemplate,
+    const std::span<const DescriptorData> data)
+{
+    const VkDescriptorSet set = Allocate(updateTemplate.GetLayout());
+
+    updateTemplate.Update(set, data);
+
+    return set;
+}
\ No newline at end of file
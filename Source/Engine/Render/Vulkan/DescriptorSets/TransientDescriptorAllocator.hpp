@@ -0,0 +1,51 @@
+#pragma once
+
+#include <volk.h>
+
+#include "Engine/Render/Vulkan/VulkanConfig.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetPool.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/DescriptorUpdateTemplate.hpp"
+
+class VulkanContext;
+
+// Linear allocator for sets which live for a single frame only. Each frame in flight owns its ring of pools,
+// allocations just bump through them and the whole ring is reset at once when the frame is reused.
+// Long-lived sets stay in DescriptorSetAllocator pools so transient ones never fragment them
+class TransientDescriptorAllocator
+{
+public:
+    using SizeRatio = DescriptorSetPool::SizeRatio;
+
+    TransientDescriptorAllocator(uint32_t maxSetsInPool, std::span<const SizeRatio> poolRatios,
+        const VulkanContext& vulkanContext);
+    ~TransientDescriptorAllocator();
+
+    TransientDescriptorAllocator(const TransientDescriptorAllocator&) = delete;
+    TransientDescriptorAllocator& operator=(const TransientDescriptorAllocator&) = delete;
+
+    TransientDescriptorAllocator(TransientDescriptorAllocator&&) = delete;
+    TransientDescriptorAllocator& operator=(TransientDescriptorAllocator&&) = delete;
+
+    // Call only when gpu is done with the frame, resets all sets allocated the last time frame was current
+    void BeginFrame(uint32_t frameIndex);
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    // Allocates the set for the template layout and writes it with a single template update
+    VkDescriptorSet Allocate(const DescriptorUpdateTemplate& updateTemplate, std::span<const DescriptorData> data);
+
+private:
+    struct FramePools
+    {
+        std::vector<DescriptorSetPool> pools;
+        size_t currentPool = 0;
+    };
+
+    const VulkanContext* vulkanContext = nullptr;
+
+    uint32_t maxSetsInPool = VulkanConfig::maxSetsInPool;
+    std::vector<SizeRatio> poolRatios;
+
+    std::array<FramePools, VulkanConfig::maxFramesInFlight> framePools;
+    uint32_t currentFrame = 0;
+};
\ No newline at end of file
@@ -24,7 +24,10 @@ struct DeviceProperties
 {
     VkPhysicalDeviceProperties physicalProperties;
     VkSampleCountFlagBits maxSampleCount = VK_SAMPLE_COUNT_1_BIT;
+    VkSampleCountFlags supportedSampleCounts = VK_SAMPLE_COUNT_1_BIT; // For both color and depth attachments
+    bool lazilyAllocatedMemorySupported = false; // Usually on tile based gpus only
     bool meshShadersSupported = false;
+    bool memoryBudgetSupported = false;
 };
 
 class Device
@@ -79,5 +82,5 @@ private:
     mutable std::unordered_map<CommandBufferType, VkCommandPool> commandPools;
 
     VkCommandBuffer oneTimeCommandBuffer;
-    CommandBufferSync oneTimeCommandBufferSync;
+    mutable CommandBufferSync oneTimeCommandBufferSync;
 };
@@ -2,11 +2,14 @@
 
 #include <volk.h>
 
+#include "Engine/Render/Vulkan/GpuTimers.hpp"
+#include "Engine/Render/Vulkan/CommandRecorder.hpp"
 #include "Engine/Render/Vulkan/Synchronization/CommandBufferSync.hpp"
 
 struct RenderStats
 {
     uint64_t triangleCount = 0; // VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+    std::array<float, GpuTimers::timerCount> gpuTimesMs = {};
 };
 
 struct Frame
@@ -15,6 +18,8 @@ struct Frame
     uint32_t swapchainImageIndex = 0;
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
     CommandBufferSync sync;
+    std::unique_ptr<CommandRecorder> recorder;
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE; // See GpuTimers
 
     RenderStats stats;
 };
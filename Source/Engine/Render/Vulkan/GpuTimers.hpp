@@ -0,0 +1,31 @@
+#pragma once
+
+#include <volk.h>
+
+class VulkanContext;
+
+// Each timer is a pair of timestamps, stages write them in their commands, render system reads results back
+enum class GpuTimer
+{
+    eCull = 0,
+    eSort,
+    eForward,
+    eCount
+};
+
+namespace GpuTimers
+{
+    inline constexpr uint32_t timerCount = static_cast<uint32_t>(GpuTimer::eCount);
+    inline constexpr uint32_t queryCountPerFrame = timerCount * 2;
+
+    VkQueryPool CreateQueryPool(const VulkanContext& vulkanContext);
+
+    void Reset(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t frameIndex);
+
+    void Begin(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t frameIndex, GpuTimer timer);
+    void End(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t frameIndex, GpuTimer timer);
+
+    // Timers that weren't written during the frame get zero time
+    void GetResults(const VulkanContext& vulkanContext, VkQueryPool queryPool, uint32_t frameIndex,
+        std::span<float, timerCount> timesMs);
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <volk.h>
 
+#include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
+
 class VulkanContext;
 
 struct ImageDescription
@@ -48,6 +50,7 @@ private:
     const VulkanContext* vulkanContext = nullptr;
 
     VkImage image = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE; // Swapchain images don't have one
     
     ImageDescription description = {};
     
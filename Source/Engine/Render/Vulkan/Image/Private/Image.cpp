@@ -4,7 +4,8 @@
 
 namespace ImageDetails
 {
-    static VkImage CreateImage(const ImageDescription& description, const VulkanContext& vulkanContext)
+    static std::pair<VkImage, VmaAllocation> CreateImage(const ImageDescription& description,
+        const VulkanContext& vulkanContext)
     {
         // TODO: move more of these as parameters
         VkImageCreateInfo imageInfo{};
@@ -38,26 +39,32 @@ Image::Image(VkImage aImage, ImageDescription aDescription, const VulkanContext&
 }
 
 Image::Image(ImageDescription aDescription, const VulkanContext& aVulkanContext)
-    : Image(ImageDetails::CreateImage(aDescription, aVulkanContext), std::move(aDescription), aVulkanContext, false)
-{}
+    : vulkanContext{ &aVulkanContext }
+    , description{ std::move(aDescription) }
+{
+    std::tie(image, allocation) = ImageDetails::CreateImage(description, *vulkanContext);
+}
 
 Image::~Image()
 {
     if (IsValid() && !isSwapchainImage)
     {
-        vulkanContext->GetMemoryManager().DestroyImage(image);
+        vulkanContext->GetMemoryManager().DestroyImage(image, allocation);
         image = VK_NULL_HANDLE;
+        allocation = VK_NULL_HANDLE;
     }
 }
 
 Image::Image(Image&& other) noexcept
     : vulkanContext{ other.vulkanContext }
     , image{ other.image }
+    , allocation{ other.allocation }
     , description{ std::move(other.description) }
     , isSwapchainImage{ other.isSwapchainImage }
 {
     other.vulkanContext = nullptr;
     other.image = VK_NULL_HANDLE;
+    other.allocation = VK_NULL_HANDLE;
     other.description = {};
     other.isSwapchainImage = false;
 }
@@ -68,6 +75,7 @@ Image& Image::operator=(Image&& other) noexcept
     {
         std::swap(vulkanContext, other.vulkanContext);
         std::swap(image, other.image);
+        std::swap(allocation, other.allocation);
         std::swap(description, other.description);
         std::swap(isSwapchainImage, other.isSwapchainImage);
     }
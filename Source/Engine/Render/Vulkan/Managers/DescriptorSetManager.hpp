@@ -4,6 +4,7 @@
 #include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetBuilder.hpp"
 #include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetAllocator.hpp"
 #include "Engine/Render/Vulkan/DescriptorSets/DescriptorSetLayoutCache.hpp"
+#include "Engine/Render/Vulkan/DescriptorSets/TransientDescriptorAllocator.hpp"
 
 class VulkanContext;
 
@@ -31,12 +32,23 @@ public:
     DescriptorSetBuilder GetDescriptorSetBuilder(DescriptorScope scope = DescriptorScope::eGlobal);
     DescriptorSetBuilder GetDescriptorSetBuilder(DescriptorSetLayout layout, DescriptorScope scope = DescriptorScope::eGlobal);
 
+    // Call only when gpu is done with the frame, recycles pools of all scopes and transient sets of the frame
+    void BeginFrame(uint32_t frameIndex);
+
     void ResetDescriptors(DescriptorScope scope);
 
+    // For sets which are rewritten every frame, see TransientDescriptorAllocator
+    TransientDescriptorAllocator& GetTransientAllocator()
+    {
+        return transientAllocator;
+    }
+
 private:
     const VulkanContext& vulkanContext;
 
     DescriptorSetLayoutCache cache;
 
     std::unordered_map<DescriptorScope, DescriptorSetAllocator> allocators;
+
+    TransientDescriptorAllocator transientAllocator;
 };
@@ -6,8 +6,50 @@ DISABLE_WARNINGS_BEGIN
 #include <vk_mem_alloc.h>
 DISABLE_WARNINGS_END
 
+#include <mutex>
+
 class VulkanContext;
+class Buffer;
+class CommandRecorder;
+
+// Only used for statistics, so we know what occupies memory
+enum class MemoryCategory
+{
+    eOther = 0,
+    eGeometry,
+    eDraws,
+    eCommands,
+    eRenderTargets,
+    eTextures,
+    eStaging,
+    eCount
+};
+
+struct MemoryStats
+{
+    struct Heap
+    {
+        VkDeviceSize budget = 0; // Estimated by VMA if VK_EXT_memory_budget isn't supported
+        VkDeviceSize usage = 0; // Includes other processes if VK_EXT_memory_budget is supported
+        bool deviceLocal = false;
+    };
 
+    struct Category
+    {
+        VkDeviceSize size = 0;
+        uint32_t allocationCount = 0;
+    };
+
+    static constexpr size_t categoryCount = static_cast<size_t>(MemoryCategory::eCount);
+
+    std::vector<Heap> heaps;
+    std::array<Category, categoryCount> categories = {};
+    uint32_t blockCount = 0;
+    uint32_t allocationCount = 0;
+};
+
+// Resources keep the allocation they get on creation and pass it back, so nothing is looked up per call.
+// Safe to call from any thread: VMA synchronizes itself and statistics are guarded by a mutex
 class MemoryManager
 {
 public:
@@ -20,22 +62,71 @@ public:
     MemoryManager(MemoryManager&&) = delete;
     MemoryManager& operator=(MemoryManager&&) = delete;
 
-    VkBuffer CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo, const VkMemoryPropertyFlags memoryProperties);
-    void DestroyBuffer(VkBuffer buffer);
+    std::pair<VkBuffer, VmaAllocation> CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo,
+        VkMemoryPropertyFlags memoryProperties, MemoryCategory category);
+    void DestroyBuffer(VkBuffer buffer, VmaAllocation allocation);
+
+    std::pair<VkImage, VmaAllocation> CreateImage(const VkImageCreateInfo& imageCreateInfo,
+        VkMemoryPropertyFlags memoryProperties);
+    void DestroyImage(VkImage image, VmaAllocation allocation);
 
-    void CopyMemoryToBuffer(VkBuffer buffer, std::span<const std::byte> data, size_t offset);
+    void CopyMemoryToAllocation(VmaAllocation allocation, std::span<const std::byte> data, size_t offset);
 
-    void* MapBufferMemory(VkBuffer buffer);
-    void UnmapBufferMemory(VkBuffer buffer);
+    void* MapMemory(VmaAllocation allocation);
+    void UnmapMemory(VmaAllocation allocation);
 
-    VkImage CreateImage(const VkImageCreateInfo& imageCreateInfo, const VkMemoryPropertyFlags memoryProperties);
-    void DestroyImage(VkImage image);
+    // Only registered buffers are moved by defragmentation. Owners must unregister them before destruction and
+    // refresh device addresses and recorded commands on ES::BuffersRelocated
+    void RegisterRelocatable(Buffer& buffer);
+    void UnregisterRelocatable(const Buffer& buffer);
+
+    // Call once per frame when gpu is done with the frame and before the deletion queue flush. Starts defragmentation
+    // once memory gets fragmented, then moves a small batch of buffers per pass. Copies are recorded ahead of
+    // the frame commands, frames in flight could use old buffers until the pass is finished the next time
+    // the frame is current. Returns true if any buffer was moved
+    bool Defragment(uint32_t frameIndex, CommandRecorder& recorder);
+
+    // Finishes the pass in progress right away, gpu has to be idle
+    void EndDefragmentation();
+
+    // Call once per frame with an ever increasing number, VMA refetches budgets from the driver on its change
+    void SetCurrentFrame(uint32_t frameNumber);
+
+    // Budgets are the ones VMA fetched for the current frame, see SetCurrentFrame. Cheap enough to query every frame
+    MemoryStats GetStats() const;
+
+    // Highest usage / budget ratio among device local heaps, lets the engine react before oversubscribing
+    float GetDeviceLocalBudgetUsage() const;
+
+private:
+    struct DefragmentationPass
+    {
+        VmaDefragmentationPassMoveInfo moves = {};
+        std::vector<VkBuffer> oldBuffers; // Retired when the pass ends, moved buffers already use new ones
+        uint32_t frameIndex = 0;
+    };
+
+    bool IsFragmented() const;
+
+    bool BeginDefragmentationPass(uint32_t frameIndex, CommandRecorder& recorder);
+    // Returns false if there is nothing left to move
+    bool EndDefragmentationPass();
+
+    // Category is kept as allocation user data
+    void AddToStats(VmaAllocation allocation);
+    void RemoveFromStats(VmaAllocation allocation);
 
-private:    
     const VulkanContext& vulkanContext;
 
-   VmaAllocator allocator;
+    VmaAllocator allocator;
+
+    mutable std::mutex statsMutex;
+    std::array<MemoryStats::Category, MemoryStats::categoryCount> categoryStats = {};
+
+    std::mutex relocatablesMutex;
+    std::unordered_map<VmaAllocation, Buffer*> relocatableBuffers;
 
-   std::unordered_map<VkBuffer, VmaAllocation> bufferAllocations;
-   std::unordered_map<VkImage, VmaAllocation> imageAllocations;
+    VmaDefragmentationContext defragmentationContext = VK_NULL_HANDLE;
+    std::optional<DefragmentationPass> defragmentationPass;
+    uint32_t framesSinceFragmentationCheck = 0;
 };
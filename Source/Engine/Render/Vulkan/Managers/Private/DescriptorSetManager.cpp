@@ -6,6 +6,7 @@
 DescriptorSetManager::DescriptorSetManager(const VulkanContext& aVulkanContext)
     : vulkanContext{aVulkanContext}
     , cache{vulkanContext}
+    , transientAllocator{VulkanConfig::maxSetsInPool, VulkanConfig::defaultPoolSizeRatios, vulkanContext}
 {
     using namespace VulkanConfig;
 
@@ -35,6 +36,16 @@ DescriptorSetBuilder DescriptorSetManager::GetDescriptorSetBuilder(const Descrip
     return { allocators.at(scope), layout, vulkanContext };
 }
 
+void DescriptorSetManager::BeginFrame(const uint32_t frameIndex)
+{
+    for (DescriptorSetAllocator& allocator : allocators | std::views::values)
+    {
+        allocator.BeginFrame(frameIndex);
+    }
+
+    transientAllocator.BeginFrame(frameIndex);
+}
+
 void DescriptorSetManager::ResetDescriptors(const DescriptorScope scope)
 {
     allocators[scope].ResetPools();
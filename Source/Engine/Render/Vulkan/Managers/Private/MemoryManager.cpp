@@ -2,16 +2,77 @@
 
 #include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Buffer/Buffer.hpp"
+#include "Engine/Render/Vulkan/CommandRecorder.hpp"
+#include "Engine/Render/Vulkan/Synchronization/SynchronizationUtils.hpp"
 
 namespace MemoryManagerDetails
 {
-    template<typename T>
-    static VmaAllocation GetAllocation(const T resource, std::unordered_map<T, VmaAllocation>& allocations)
+    // Statistics walk all of the blocks, so fragmentation is checked only once in a while
+    static constexpr uint32_t fragmentationCheckInterval = 1000;
+    static constexpr VkDeviceSize minFragmentedBytes = 64 * 1024 * 1024;
+    static constexpr float maxFragmentedRatio = 0.25f;
+
+    // Small passes keep the per frame copy cheap
+    static constexpr VkDeviceSize maxDefragmentationBytesPerPass = 32 * 1024 * 1024;
+    static constexpr uint32_t maxDefragmentationAllocationsPerPass = 16;
+
+    // Frames in flight might still write old buffers, and the destination memory might have been used by freed ones
+    static constexpr PipelineBarrier beforeMoveBarrier = {
+        .srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT };
+
+    // Moved buffers could be of any usage, so everything after the copy waits for it
+    static constexpr PipelineBarrier afterMoveBarrier = {
+        .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
+
+    struct BufferMove
+    {
+        VkBuffer source = VK_NULL_HANDLE;
+        VkBuffer destination = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+    };
+
+    static VmaAllocationCreateInfo GetAllocationCreateInfo(const VkMemoryPropertyFlags memoryProperties,
+        const MemoryCategory category)
+    {
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.requiredFlags = memoryProperties;
+        allocInfo.pUserData = reinterpret_cast<void*>(static_cast<uintptr_t>(category));
+
+        return allocInfo;
+    }
+
+    static MemoryCategory GetCategory(const VmaAllocationInfo& allocationInfo)
+    {
+        return static_cast<MemoryCategory>(reinterpret_cast<uintptr_t>(allocationInfo.pUserData));
+    }
+
+    static VkBufferCreateInfo GetBufferCreateInfo(const BufferDescription& description,
+        const VulkanContext& vulkanContext)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = description.size;
+        bufferInfo.usage = description.usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.queueFamilyIndexCount = 1;
+        bufferInfo.pQueueFamilyIndices = &vulkanContext.GetDevice().GetQueues().familyIndices.graphicsAndComputeFamily;
+
+        return bufferInfo;
+    }
+
+    static MemoryCategory GetImageCategory(const VkImageCreateInfo& imageCreateInfo)
     {
-        const auto it = allocations.find(resource);
-        Assert(it != allocations.end());
+        constexpr VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
 
-        return it->second;
+        return imageCreateInfo.usage & attachmentUsage ? MemoryCategory::eRenderTargets : MemoryCategory::eTextures;
     }
 }
 
@@ -23,6 +84,11 @@ MemoryManager::MemoryManager(const VulkanContext& aVulkanContext)
     vulkanFunctions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
 
     VmaAllocatorCreateInfo allocatorInfo{};
+    allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    if (vulkanContext.GetDevice().GetProperties().memoryBudgetSupported)
+    {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     allocatorInfo.vulkanApiVersion = VulkanConfig::apiVersion;
     allocatorInfo.physicalDevice = vulkanContext.GetDevice().GetPhysicalDevice();
     allocatorInfo.device = vulkanContext.GetDevice();
@@ -34,16 +100,15 @@ MemoryManager::MemoryManager(const VulkanContext& aVulkanContext)
 
 MemoryManager::~MemoryManager()
 {
-    Assert(bufferAllocations.empty());
-    Assert(imageAllocations.empty());
+    Assert(defragmentationContext == VK_NULL_HANDLE);
+    Assert(std::ranges::all_of(categoryStats, [](const auto& category) { return category.allocationCount == 0; }));
     vmaDestroyAllocator(allocator);
 }
 
-VkBuffer MemoryManager::CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo, 
-    const VkMemoryPropertyFlags memoryProperties)
+std::pair<VkBuffer, VmaAllocation> MemoryManager::CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo, 
+    const VkMemoryPropertyFlags memoryProperties, const MemoryCategory category)
 {
-    VmaAllocationCreateInfo allocInfo{};
-    allocInfo.requiredFlags = memoryProperties;
+    const VmaAllocationCreateInfo allocInfo = MemoryManagerDetails::GetAllocationCreateInfo(memoryProperties, category);
 
     VkBuffer buffer;
     VmaAllocation allocation;
@@ -51,32 +116,53 @@ VkBuffer MemoryManager::CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo,
     const VkResult result = vmaCreateBuffer(allocator, &bufferCreateInfo, &allocInfo, &buffer, &allocation, nullptr);
     Assert(result == VK_SUCCESS);
 
-    bufferAllocations.emplace(buffer, allocation);
+    AddToStats(allocation);
 
-    return buffer;
+    return { buffer, allocation };
 }
 
-void MemoryManager::DestroyBuffer(const VkBuffer buffer)
+void MemoryManager::DestroyBuffer(const VkBuffer buffer, const VmaAllocation allocation)
 {
-    const VmaAllocation allocation = MemoryManagerDetails::GetAllocation(buffer, bufferAllocations);
+    RemoveFromStats(allocation);
 
     vmaDestroyBuffer(allocator, buffer, allocation);
+}
 
-    bufferAllocations.erase(buffer);
+std::pair<VkImage, VmaAllocation> MemoryManager::CreateImage(const VkImageCreateInfo& imageCreateInfo, 
+    const VkMemoryPropertyFlags memoryProperties)
+{
+    using namespace MemoryManagerDetails;
+
+    const VmaAllocationCreateInfo allocInfo = GetAllocationCreateInfo(memoryProperties,
+        GetImageCategory(imageCreateInfo));
+
+    VkImage image;
+    VmaAllocation allocation;
+
+    const VkResult result = vmaCreateImage(allocator, &imageCreateInfo, &allocInfo, &image, &allocation, nullptr);
+    Assert(result == VK_SUCCESS);
+
+    AddToStats(allocation);
+
+    return { image, allocation };
 }
 
-void MemoryManager::CopyMemoryToBuffer(const VkBuffer buffer, const std::span<const std::byte> data, const size_t offset)
+void MemoryManager::DestroyImage(const VkImage image, const VmaAllocation allocation)
 {
-    const VmaAllocation allocation = MemoryManagerDetails::GetAllocation(buffer, bufferAllocations);
+    RemoveFromStats(allocation);
+
+    vmaDestroyImage(allocator, image, allocation);
+}
 
+void MemoryManager::CopyMemoryToAllocation(const VmaAllocation allocation, const std::span<const std::byte> data,
+    const size_t offset)
+{
     const VkResult result = vmaCopyMemoryToAllocation(allocator, data.data(), allocation, offset, data.size());
     Assert(result == VK_SUCCESS);
 }
 
-void* MemoryManager::MapBufferMemory(const VkBuffer buffer)
+void* MemoryManager::MapMemory(const VmaAllocation allocation)
 {
-    const VmaAllocation allocation = MemoryManagerDetails::GetAllocation(buffer, bufferAllocations);
-
     void* mappedData;
     const VkResult result = vmaMapMemory(allocator, allocation, &mappedData);
     Assert(result == VK_SUCCESS);
@@ -84,35 +170,259 @@ void* MemoryManager::MapBufferMemory(const VkBuffer buffer)
     return mappedData;
 }
 
-void MemoryManager::UnmapBufferMemory(const VkBuffer buffer)
+void MemoryManager::UnmapMemory(const VmaAllocation allocation)
 {
-    const VmaAllocation allocation = MemoryManagerDetails::GetAllocation(buffer, bufferAllocations);
-
     vmaUnmapMemory(allocator, allocation);
 }
 
-VkImage MemoryManager::CreateImage(const VkImageCreateInfo& imageCreateInfo, 
-    const VkMemoryPropertyFlags memoryProperties)
+void MemoryManager::RegisterRelocatable(Buffer& buffer)
 {
-    VmaAllocationCreateInfo allocInfo{};
-    allocInfo.requiredFlags = memoryProperties;
+    // Mapped memory would move under the owner
+    Assert(buffer.IsValid() && (buffer.GetDescription().memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0);
 
-    VkImage image;
-    VmaAllocation allocation;
+    std::scoped_lock lock(relocatablesMutex);
+    relocatableBuffers.emplace(buffer.GetAllocation(), &buffer);
+}
 
-    const VkResult result = vmaCreateImage(allocator, &imageCreateInfo, &allocInfo, &image, &allocation, nullptr);
-    Assert(result == VK_SUCCESS);
+void MemoryManager::UnregisterRelocatable(const Buffer& buffer)
+{
+    std::scoped_lock lock(relocatablesMutex);
+    relocatableBuffers.erase(buffer.GetAllocation());
+}
+
+bool MemoryManager::Defragment(const uint32_t frameIndex, CommandRecorder& recorder)
+{
+    using namespace MemoryManagerDetails;
+
+    if (defragmentationPass)
+    {
+        if (defragmentationPass->frameIndex != frameIndex)
+        {
+            return false;
+        }
+
+        if (!EndDefragmentationPass())
+        {
+            EndDefragmentation();
+            return false;
+        }
+    }
+    else if (defragmentationContext == VK_NULL_HANDLE)
+    {
+        if (++framesSinceFragmentationCheck < fragmentationCheckInterval)
+        {
+            return false;
+        }
+
+        framesSinceFragmentationCheck = 0;
 
-    imageAllocations.emplace(image, allocation);
+        if (!IsFragmented())
+        {
+            return false;
+        }
 
-    return image;
+        VmaDefragmentationInfo defragmentationInfo{};
+        defragmentationInfo.maxBytesPerPass = maxDefragmentationBytesPerPass;
+        defragmentationInfo.maxAllocationsPerPass = maxDefragmentationAllocationsPerPass;
+
+        const VkResult result = vmaBeginDefragmentation(allocator, &defragmentationInfo, &defragmentationContext);
+        Assert(result == VK_SUCCESS);
+    }
+
+    return BeginDefragmentationPass(frameIndex, recorder);
 }
 
-void MemoryManager::DestroyImage(const VkImage image)
+void MemoryManager::EndDefragmentation()
 {
-    const VmaAllocation allocation = MemoryManagerDetails::GetAllocation(image, imageAllocations);
+    if (defragmentationPass)
+    {
+        EndDefragmentationPass();
+    }
 
-    vmaDestroyImage(allocator, image, allocation);
+    if (defragmentationContext == VK_NULL_HANDLE)
+    {
+        return;
+    }
 
-    imageAllocations.erase(image);
+    VmaDefragmentationStats defragmentationStats;
+    vmaEndDefragmentation(allocator, defragmentationContext, &defragmentationStats);
+    defragmentationContext = VK_NULL_HANDLE;
+
+    LogI << "Defragmentation moved " << defragmentationStats.allocationsMoved << " allocations ("
+        << defragmentationStats.bytesMoved / 1024 << " KB), freed " << defragmentationStats.deviceMemoryBlocksFreed
+        << " blocks (" << defragmentationStats.bytesFreed / 1024 << " KB)\n";
 }
+
+MemoryStats MemoryManager::GetStats() const
+{
+    MemoryStats stats;
+
+    {
+        std::scoped_lock lock(statsMutex);
+        stats.categories = categoryStats;
+    }
+
+    const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+    vmaGetMemoryProperties(allocator, &memoryProperties);
+
+    std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
+    {
+        stats.heaps.push_back({
+            .budget = budgets[i].budget,
+            .usage = budgets[i].usage,
+            .deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0 });
+
+        stats.blockCount += budgets[i].statistics.blockCount;
+        stats.allocationCount += budgets[i].statistics.allocationCount;
+    }
+
+    return stats;
+}
+
+void MemoryManager::SetCurrentFrame(const uint32_t frameNumber)
+{
+    vmaSetCurrentFrameIndex(allocator, frameNumber);
+}
+
+float MemoryManager::GetDeviceLocalBudgetUsage() const
+{
+    float maxUsage = 0.0f;
+
+    for (const MemoryStats::Heap& heap : GetStats().heaps)
+    {
+        if (heap.deviceLocal && heap.budget > 0)
+        {
+            maxUsage = std::max(maxUsage, static_cast<float>(heap.usage) / static_cast<float>(heap.budget));
+        }
+    }
+
+    return maxUsage;
+}
+
+bool MemoryManager::IsFragmented() const
+{
+    using namespace MemoryManagerDetails;
+
+    VmaTotalStatistics statistics;
+    vmaCalculateStatistics(allocator, &statistics);
+
+    const VkDeviceSize blockBytes = statistics.total.statistics.blockBytes;
+    const VkDeviceSize unusedBytes = blockBytes - statistics.total.statistics.allocationBytes;
+
+    return unusedBytes > minFragmentedBytes
+        && static_cast<float>(unusedBytes) > static_cast<float>(blockBytes) * maxFragmentedRatio;
+}
+
+bool MemoryManager::BeginDefragmentationPass(const uint32_t frameIndex, CommandRecorder& recorder)
+{
+    using namespace MemoryManagerDetails;
+
+    VmaDefragmentationPassMoveInfo moves{};
+
+    if (vmaBeginDefragmentationPass(allocator, defragmentationContext, &moves) == VK_SUCCESS)
+    {
+        EndDefragmentation();
+        return false;
+    }
+
+    DefragmentationPass& pass = defragmentationPass.emplace();
+    pass.moves = moves;
+    pass.frameIndex = frameIndex;
+
+    // Only buffers whose owners can follow the move are copied, VMA keeps the rest (images included) in place
+    std::vector<BufferMove> bufferMoves;
+
+    {
+        std::scoped_lock lock(relocatablesMutex);
+
+        for (uint32_t i = 0; i < moves.moveCount; ++i)
+        {
+            VmaDefragmentationMove& move = moves.pMoves[i];
+
+            const auto it = relocatableBuffers.find(move.srcAllocation);
+
+            if (it == relocatableBuffers.end())
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            Buffer& buffer = *it->second;
+            const VkBufferCreateInfo bufferInfo = GetBufferCreateInfo(buffer.GetDescription(), vulkanContext);
+
+            VkBuffer newBuffer;
+            const VkResult result = vmaCreateAliasingBuffer(allocator, move.dstTmpAllocation, &bufferInfo, &newBuffer);
+            Assert(result == VK_SUCCESS);
+
+            pass.oldBuffers.push_back(buffer.ReplaceHandle(newBuffer));
+            bufferMoves.push_back({ pass.oldBuffers.back(), newBuffer, buffer.GetDescription().size });
+        }
+    }
+
+    if (bufferMoves.empty())
+    {
+        return false;
+    }
+
+    // Recorded ahead of the frame commands, so new buffers are used by this frame onwards. Queue submission order
+    // puts the copy after the previous frames, no need to wait for them on the cpu
+    recorder.Record([bufferMoves = std::move(bufferMoves)](const VkCommandBuffer cmd) {
+        SynchronizationUtils::SetMemoryBarrier(cmd, beforeMoveBarrier);
+
+        for (const auto& [source, destination, size] : bufferMoves)
+        {
+            const VkBufferCopy region = { .size = size };
+            vkCmdCopyBuffer(cmd, source, destination, 1, &region);
+        }
+
+        SynchronizationUtils::SetMemoryBarrier(cmd, afterMoveBarrier);
+    });
+
+    return true;
+}
+
+bool MemoryManager::EndDefragmentationPass()
+{
+    // Nothing reads old buffers anymore, handles outliving the memory released below is fine
+    for (const VkBuffer oldBuffer : defragmentationPass->oldBuffers)
+    {
+        vulkanContext.GetDeletionQueue().Enqueue(oldBuffer);
+    }
+
+    // Moved allocations now point to the new memory, the old one is released by VMA
+    const VkResult result = vmaEndDefragmentationPass(allocator, defragmentationContext, &defragmentationPass->moves);
+    defragmentationPass.reset();
+
+    return result == VK_INCOMPLETE;
+}
+
+void MemoryManager::AddToStats(const VmaAllocation allocation)
+{
+    VmaAllocationInfo allocationInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+
+    const auto categoryIndex = static_cast<size_t>(MemoryManagerDetails::GetCategory(allocationInfo));
+
+    std::scoped_lock lock(statsMutex);
+
+    MemoryStats::Category& category = categoryStats[categoryIndex];
+    category.size += allocationInfo.size;
+    ++category.allocationCount;
+}
+
+void MemoryManager::RemoveFromStats(const VmaAllocation allocation)
+{
+    VmaAllocationInfo allocationInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+
+    const auto categoryIndex = static_cast<size_t>(MemoryManagerDetails::GetCategory(allocationInfo));
+
+    std::scoped_lock lock(statsMutex);
+
+    MemoryStats::Category& category = categoryStats[categoryIndex];
+    category.size -= allocationInfo.size;
+    --category.allocationCount;
+}
\ No newline at end of file
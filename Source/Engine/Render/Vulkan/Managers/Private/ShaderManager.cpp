@@ -6,12 +6,14 @@ DISABLE_WARNINGS_END
 
 #include "Utils/Helpers.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Shaders/EmbeddedShaders.hpp"
 
 namespace ShaderManagerDetails
 {
     constexpr std::string_view shadersDir = "~/Shaders";
     constexpr std::string_view compiledShadersDir = "~/Shaders/Compiled";
     constexpr std::string_view compiledFileExtension = ".spv";
+    constexpr std::string_view hashFileExtension = ".hash";
 
     static FilePath CreateCompiledShaderPath(const FilePath& path)
     {
@@ -20,10 +22,126 @@ namespace ShaderManagerDetails
         
         return FilePath(compiledShadersDir) / relativeToShadersDir;
     }
+
+    // Path relative to the shaders dir, same form as include names and file watcher changes
+    static std::string GetShaderName(const FilePath& path)
+    {
+        return std::filesystem::path(path.GetRelativeTo(FilePath(shadersDir))).generic_string();
+    }
+
+    static FilePath CreateHashPath(const FilePath& compiledShaderPath)
+    {
+        return FilePath(compiledShaderPath.GetAbsolute().append(hashFileExtension));
+    }
+
+    // Same lookup as the compiler does: next to the including file first, then in the shaders dir
+    static std::optional<FilePath> ResolveInclude(const FilePath& includerPath, const std::string_view name)
+    {
+        if (FilePath includePath = FilePath(includerPath.GetDirectory()) / name; includePath.Exists())
+        {
+            return includePath;
+        }
+
+        if (FilePath includePath = FilePath(shadersDir) / name; includePath.Exists())
+        {
+            return includePath;
+        }
+
+        return std::nullopt;
+    }
+
+    // Includes are stored relative to the shaders dir, see GetShaderName
+    static void CollectIncludes(const std::string_view glslCode, const FilePath& path, std::set<std::string>& includes)
+    {
+        constexpr std::string_view includeDirective = "#include";
+
+        for (const auto lineRange : std::views::split(glslCode, '\n'))
+        {
+            std::string_view line(lineRange.begin(), lineRange.end());
+
+            const size_t directiveStart = line.find_first_not_of(" \t");
+            if (directiveStart == std::string_view::npos || !line.substr(directiveStart).starts_with(includeDirective))
+            {
+                continue;
+            }
+
+            const size_t nameStart = line.find('"', directiveStart);
+            const size_t nameEnd = line.find('"', nameStart + 1);
+            if (nameStart == std::string_view::npos || nameEnd == std::string_view::npos)
+            {
+                continue;
+            }
+
+            const std::optional<FilePath> includePath = ResolveInclude(path, line.substr(nameStart + 1,
+                nameEnd - nameStart - 1));
+
+            if (!includePath || !includes.insert(GetShaderName(*includePath)).second)
+            {
+                continue;
+            }
+
+            const std::vector<char> includeCode = FileSystem::ReadFile(*includePath);
+            CollectIncludes(std::string_view(includeCode.data(), includeCode.size()), *includePath, includes);
+        }
+    }
+
+    // Source, all of the transitive includes, stage and compiler options, anything else can't change the output
+    static uint64_t ComputeShaderHash(const std::string_view glslCode, const std::set<std::string>& includes,
+        const ShaderType shaderType, const bool optimize)
+    {
+        using namespace Helpers;
+
+        uint64_t hash = Fnv1a(std::as_bytes(std::span(glslCode)));
+
+        // Set keeps includes sorted, so the order is stable
+        for (const std::string& include : includes)
+        {
+            const std::vector<char> includeCode = FileSystem::ReadFile(FilePath(shadersDir) / include);
+
+            hash = Fnv1a(std::as_bytes(std::span(include)), hash);
+            hash = Fnv1a(std::as_bytes(std::span(includeCode)), hash);
+        }
+
+        hash = Fnv1a(std::as_bytes(std::span(&shaderType, 1)), hash);
+
+        const std::string optionsKey = ShaderCompiler::GetOptionsKey(optimize);
+        hash = Fnv1a(std::as_bytes(std::span(optionsKey)), hash);
+
+        return hash;
+    }
+
+    static bool IsCachedShaderValid(const FilePath& compiledShaderPath, const uint64_t hash)
+    {
+        const FilePath hashPath = CreateHashPath(compiledShaderPath);
+
+        if (!compiledShaderPath.Exists() || !hashPath.Exists())
+        {
+            return false;
+        }
+
+        std::ifstream hashFile(hashPath.GetAbsolute());
+
+        uint64_t cachedHash = 0;
+        hashFile >> std::hex >> cachedHash;
+
+        return !hashFile.fail() && cachedHash == hash;
+    }
+
+    static void SaveCachedShaderHash(const FilePath& compiledShaderPath, const uint64_t hash)
+    {
+        std::ofstream hashFile(CreateHashPath(compiledShaderPath).GetAbsolute(), std::ios::trunc);
+        hashFile << std::hex << hash;
+    }
+
+    static std::span<const uint32_t> AsSpirv(const std::vector<char>& data)
+    {
+        return { reinterpret_cast<const uint32_t*>(data.data()), data.size() / sizeof(uint32_t) };
+    }
 }
 
 ShaderManager::ShaderManager(const VulkanContext& aVulkanContext)
     : vulkanContext{aVulkanContext}
+    , useEmbeddedShaders{ EmbeddedShaders::IsEnabled() }
 {}
 
 ShaderModule ShaderManager::CreateShaderModule(const FilePath& path, const ShaderType shaderType,
@@ -32,41 +150,184 @@ ShaderModule ShaderManager::CreateShaderModule(const FilePath& path, const Shade
     using namespace ShaderManagerDetails;
     
     ScopeTimer timer(path.GetFileNameWithExtension());
+
+    if (useEmbeddedShaders)
+    {
+        if (const std::span<const uint32_t> spirv = EmbeddedShaders::Find(GetShaderName(path)); !spirv.empty())
+        {
+            // Includes are still tracked, so the first reload after a header edit rebuilds only its users
+            if (path.Exists())
+            {
+                const std::vector<char> glslFile = FileSystem::ReadFile(path);
+
+                std::set<std::string> includes;
+                CollectIncludes(std::string_view(glslFile.data(), glslFile.size()), path, includes);
+
+                std::scoped_lock lock(includesMutex);
+                shaderIncludes[GetShaderName(path)] = std::move(includes);
+            }
+
+            return CreateShaderModule(spirv, shaderType);
+        }
+    }
     
     Assert(path.Exists());
     
-    const std::vector<char> glslCode = FileSystem::ReadFile(path);
-    
-    const std::vector<uint32_t> spirv = ShaderCompiler::Compile(std::string_view(glslCode.data(), glslCode.size()),
-        shaderType, FilePath(shadersDir));
+    const std::vector<char> glslFile = FileSystem::ReadFile(path);
+    const std::string_view glslCode(glslFile.data(), glslFile.size());
     
+    std::set<std::string> includes;
+    CollectIncludes(glslCode, path, includes);
+
     const FilePath compiledShaderPath = CreateCompiledShaderPath(path);
+    const bool optimize = optimizationEnabled;
+    const uint64_t hash = ComputeShaderHash(glslCode, includes, shaderType, optimize);
+
+    {
+        std::scoped_lock lock(includesMutex);
+        shaderIncludes[GetShaderName(path)] = std::move(includes);
+    }
+
+    // Nothing that affects the output has changed since the last compilation, skip glslang entirely
+    if (const std::vector<char> cachedSpirv = LoadCachedSpirv(compiledShaderPath, hash); !cachedSpirv.empty())
+    {
+        return CreateShaderModule(AsSpirv(cachedSpirv), shaderType);
+    }
+    
+    const std::vector<uint32_t> spirv = Compile(path, glslCode, shaderType, optimize);
     
     // Create shader module on success
     if (!spirv.empty())
     {
-        FileSystem::CreateDirectories(compiledShaderPath);
-        glslang::OutputSpvBin(spirv, compiledShaderPath.GetAbsolute().c_str());
+        // Same shader might be compiled by multiple threads at once (e.g. shared fragment shader)
+        {
+            std::scoped_lock lock(cacheMutex);
+
+            FileSystem::CreateDirectories(compiledShaderPath);
+            glslang::OutputSpvBin(spirv, compiledShaderPath.GetAbsolute().c_str());
+            SaveCachedShaderHash(compiledShaderPath, hash);
+        }
         
         return CreateShaderModule(spirv, shaderType);
     }
     
-    // Try to load shader module from cache if allowed
-    if (useCacheOnFailure && compiledShaderPath.Exists())
+    // Try to load the last successfully compiled shader module if allowed, even though it's outdated
+    if (useCacheOnFailure)
     {
-        const std::vector<char> cachedSpirv = FileSystem::ReadFile(compiledShaderPath);
-        
-        if (!cachedSpirv.empty())
+        if (const std::vector<char> cachedSpirv = LoadCachedSpirv(compiledShaderPath); !cachedSpirv.empty())
         {
-            const std::span spirvSpan(reinterpret_cast<const uint32_t*>(cachedSpirv.data()), cachedSpirv.size() / sizeof(uint32_t));
-            
-            return CreateShaderModule(spirvSpan, shaderType);
+            return CreateShaderModule(AsSpirv(cachedSpirv), shaderType);
         }
     }
     
     return { VK_NULL_HANDLE, shaderType, vulkanContext };
 }
 
+std::future<ShaderModule> ShaderManager::CreateShaderModuleAsync(FilePath path, const ShaderType shaderType) const
+{
+    return std::async(std::launch::async, [this, path = std::move(path), shaderType]() {
+        return CreateShaderModule(path, shaderType);
+    });
+}
+
+std::vector<std::future<ShaderModule>> ShaderManager::CreateShaderModulesAsync(
+    const std::span<const ShaderDescription> descriptions) const
+{
+    std::vector<std::future<ShaderModule>> shaderModules;
+    shaderModules.reserve(descriptions.size());
+
+    std::ranges::transform(descriptions, std::back_inserter(shaderModules), [&](const ShaderDescription& description) {
+        return CreateShaderModuleAsync(FilePath(description.path), description.type);
+    });
+
+    return shaderModules;
+}
+
+std::vector<ShaderModule> ShaderManager::CreateShaderModules(
+    const std::span<const ShaderDescription> descriptions) const
+{
+    return WaitShaderModules(CreateShaderModulesAsync(descriptions));
+}
+
+std::vector<ShaderModule> ShaderManager::WaitShaderModules(std::vector<std::future<ShaderModule>> shaderModules)
+{
+    std::vector<ShaderModule> result;
+    result.reserve(shaderModules.size());
+
+    std::ranges::transform(shaderModules, std::back_inserter(result), [](std::future<ShaderModule>& shaderModule) {
+        return shaderModule.get();
+    });
+
+    return result;
+}
+
+bool ShaderManager::IsShaderAffected(const FilePath& path, const std::span<const std::string> changedFiles) const
+{
+    using namespace ShaderManagerDetails;
+
+    if (changedFiles.empty())
+    {
+        return true;
+    }
+
+    const std::string name = GetShaderName(path);
+
+    if (std::ranges::find(changedFiles, name) != changedFiles.end())
+    {
+        return true;
+    }
+
+    std::scoped_lock lock(includesMutex);
+
+    const auto it = shaderIncludes.find(name);
+
+    return it == shaderIncludes.end() || std::ranges::any_of(changedFiles, [&](const std::string& file) {
+        return it->second.contains(file);
+    });
+}
+
+void ShaderManager::EnableSourceCompilation() const
+{
+    useEmbeddedShaders = false;
+}
+
+void ShaderManager::SetOptimizationEnabled(const bool enabled) const
+{
+    optimizationEnabled = enabled;
+}
+
+std::vector<uint32_t> ShaderManager::Compile(const FilePath& path, const std::string_view glslCode,
+    const ShaderType shaderType, const bool optimize) const
+{
+    using namespace ShaderManagerDetails;
+
+    {
+        std::scoped_lock lock(compilerMutex);
+
+        if (!shaderCompiler)
+        {
+            shaderCompiler.emplace();
+        }
+    }
+
+    return ShaderCompiler::Compile(path, glslCode, shaderType, FilePath(shadersDir), optimize);
+}
+
+std::vector<char> ShaderManager::LoadCachedSpirv(const FilePath& compiledShaderPath,
+    const std::optional<uint64_t> hash /* = std::nullopt */) const
+{
+    using namespace ShaderManagerDetails;
+
+    std::scoped_lock lock(cacheMutex);
+
+    if (hash ? !IsCachedShaderValid(compiledShaderPath, *hash) : !compiledShaderPath.Exists())
+    {
+        return {};
+    }
+
+    return FileSystem::ReadFile(compiledShaderPath);
+}
+
 ShaderModule ShaderManager::CreateShaderModule(const std::span<const uint32_t> spirvCode, const ShaderType shaderType) const
 {
     VkShaderModuleCreateInfo createInfo{};
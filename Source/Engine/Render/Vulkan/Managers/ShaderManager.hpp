@@ -1,11 +1,21 @@
 #pragma once
 
+#include <future>
+#include <mutex>
+#include <atomic>
+
 #include "Engine/Render/Vulkan/Shaders/ShaderModule.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderCompiler.hpp"
 #include "Engine/FileSystem/FileSystem.hpp"
 
 class VulkanContext;
 
+struct ShaderDescription
+{
+    std::string_view path;
+    ShaderType type;
+};
+
 class ShaderManager
 {
 public:
@@ -13,10 +23,54 @@ public:
 
     ShaderModule CreateShaderModule(const FilePath& path, const ShaderType shaderType, bool useCacheOnFailure = true) const;
 
+    // Compilation runs on a worker thread, so owners can start all of their shaders at once
+    // and then wait only for the modules a particular pipeline needs
+    std::future<ShaderModule> CreateShaderModuleAsync(FilePath path, ShaderType shaderType) const;
+    std::vector<std::future<ShaderModule>> CreateShaderModulesAsync(
+        std::span<const ShaderDescription> descriptions) const;
+
+    // Compiles concurrently and waits for all of the modules, order matches descriptions
+    std::vector<ShaderModule> CreateShaderModules(std::span<const ShaderDescription> descriptions) const;
+
+    static std::vector<ShaderModule> WaitShaderModules(std::vector<std::future<ShaderModule>> shaderModules);
+
+    // Changed files are relative to the shaders dir, empty list means everything might have changed.
+    // Relies on includes found during the last compilation, shaders never compiled before are always affected
+    bool IsShaderAffected(const FilePath& path, std::span<const std::string> changedFiles) const;
+
+    // Embedded spirv is used until the first reload request, shaders are compiled from sources after that.
+    // Call before firing the reload so that the rebuilt pipelines pick up the changes
+    void EnableSourceCompilation() const;
+
+    // Affects shaders compiled after the call, embedded spirv is optimized according to the build config
+    void SetOptimizationEnabled(bool enabled) const;
+
+    bool IsOptimizationEnabled() const
+    {
+        return optimizationEnabled;
+    }
+
 private:
     ShaderModule CreateShaderModule(std::span<const uint32_t> spirvCode, const ShaderType shaderType) const;
+
+    // Without hash just loads the last successfully compiled spirv
+    std::vector<char> LoadCachedSpirv(const FilePath& compiledShaderPath, 
+        std::optional<uint64_t> hash = std::nullopt) const;
     
+    std::vector<uint32_t> Compile(const FilePath& path, std::string_view glslCode, ShaderType shaderType,
+        bool optimize) const;
+
     const VulkanContext& vulkanContext;
 
-    ShaderCompiler shaderCompiler;
+    // Created on the first compilation, so startup doesn't initialize glslang when everything is cached or embedded
+    mutable std::mutex compilerMutex;
+    mutable std::optional<ShaderCompiler> shaderCompiler;
+
+    mutable std::atomic<bool> useEmbeddedShaders = false;
+    mutable std::atomic<bool> optimizationEnabled = true;
+
+    mutable std::mutex cacheMutex; // Guards compiled shaders on disk
+
+    mutable std::mutex includesMutex;
+    mutable std::unordered_map<std::string, std::set<std::string>> shaderIncludes; // Transitive, by shader name
 };
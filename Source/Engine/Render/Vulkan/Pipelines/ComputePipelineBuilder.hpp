@@ -4,13 +4,14 @@
 
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderModule.hpp"
+#include "Engine/Render/Vulkan/Pipelines/SpecializationConstants.hpp"
 
 class VulkanContext;
 
 class ComputePipelineBuilder
 {
 public:
-    // TODO: Add pipeline cache and manager
+    // TODO: Add pipeline manager
     ComputePipelineBuilder(const VulkanContext& vulkanContext);
     ~ComputePipelineBuilder() = default;
 
@@ -27,6 +28,9 @@ public:
     ComputePipelineBuilder& AddPushConstantRange(VkPushConstantRange pushConstantRange); // Temp!
 
     ComputePipelineBuilder& SetShaderModule(ShaderModule&& shaderModule);
+    // Module isn't owned, so one module can be shared by several pipelines (e.g. specializations). Has to outlive Build
+    ComputePipelineBuilder& SetShaderModule(const ShaderModule& shaderModule);
+    ComputePipelineBuilder& SetSpecializationConstants(SpecializationConstants specializationConstants);
 
 private:
     const VulkanContext* vulkanContext = nullptr;
@@ -35,5 +39,7 @@ private:
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
     std::vector<VkPushConstantRange> pushConstantRanges;
 
-    std::unique_ptr<ShaderModule> shaderModule;
+    std::unique_ptr<ShaderModule> ownedShaderModule;
+    const ShaderModule* shaderModule = nullptr;
+    SpecializationConstants specializationConstants;
 };
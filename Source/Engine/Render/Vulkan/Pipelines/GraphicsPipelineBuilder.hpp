@@ -4,9 +4,9 @@
 
 #include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderModule.hpp"
+#include "Engine/Render/Vulkan/Pipelines/SpecializationConstants.hpp"
 
 class VulkanContext;
-class RenderPass;
 
 enum class InputTopology
 {
@@ -30,7 +30,7 @@ public:
     using VertexBindings = std::vector<VkVertexInputBindingDescription>;
     using VertexAttributes = std::vector<VkVertexInputAttributeDescription>;
 
-    // TODO: Add pipeline cache and manager
+    // TODO: Add pipeline manager
     GraphicsPipelineBuilder(const VulkanContext& vulkanContext);
     ~GraphicsPipelineBuilder() = default;
 
@@ -47,6 +47,7 @@ public:
     GraphicsPipelineBuilder& AddPushConstantRange(VkPushConstantRange pushConstantRange); // Temp!
 
     GraphicsPipelineBuilder& SetShaderModules(std::vector<ShaderModule>&& shaderModules);
+    GraphicsPipelineBuilder& SetSpecializationConstants(SpecializationConstants specializationConstants);
     GraphicsPipelineBuilder& SetVertexData(VertexBindings bindings, VertexAttributes attributes);
     GraphicsPipelineBuilder& SetInputTopology(InputTopology topology);
     GraphicsPipelineBuilder& SetPolygonMode(PolygonMode polygonMode);
@@ -54,7 +55,7 @@ public:
     GraphicsPipelineBuilder& SetMultisampling(VkSampleCountFlagBits sampleCount);
     GraphicsPipelineBuilder& EnableBlending();
     GraphicsPipelineBuilder& SetDepthState(bool depthTest, bool depthWrite, VkCompareOp compareOp);
-    GraphicsPipelineBuilder& SetRenderPass(const RenderPass& renderPass, uint32_t subpass = 0);
+    GraphicsPipelineBuilder& SetRenderPass(VkRenderPass renderPass, uint32_t subpass = 0);
 
 private:
     const VulkanContext* vulkanContext = nullptr;
@@ -64,6 +65,7 @@ private:
     std::vector<VkPushConstantRange> pushConstantRanges;
 
     std::vector<ShaderModule> shaderModules;
+    SpecializationConstants specializationConstants;
     VertexBindings vertexBindings;
     VertexAttributes vertexAttributes;
     std::optional<VkPipelineInputAssemblyStateCreateInfo> inputAssembly;
@@ -74,6 +76,6 @@ private:
     std::vector<VkDynamicState> dynamicStates;
     VkPipelineMultisampleStateCreateInfo multisamplingState;
     VkPipelineDepthStencilStateCreateInfo depthStencil;
-    const RenderPass* renderPass = nullptr;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
     uint32_t subpass = 0;
 };
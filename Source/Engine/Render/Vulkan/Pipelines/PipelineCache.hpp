@@ -0,0 +1,51 @@
+#pragma once
+
+#include <volk.h>
+
+#include <atomic>
+
+class VulkanContext;
+
+struct PipelineCacheStats
+{
+    bool warm = false; // Valid cache was loaded from disk
+    uint32_t pipelineCount = 0;
+    float creationTimeMs = 0.0f;
+};
+
+// Driver pipeline cache shared by all of the pipeline builders and persisted between launches.
+// Saved data is prefixed with our own header, cache is discarded if device or driver changed
+class PipelineCache
+{
+public:
+    explicit PipelineCache(const VulkanContext& aVulkanContext);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    PipelineCache(PipelineCache&&) = delete;
+    PipelineCache& operator=(PipelineCache&&) = delete;
+
+    void Save() const;
+
+    // Builders report time spent in vkCreate*Pipelines, might be called from multiple threads
+    void AddCreationTime(std::chrono::duration<float, std::milli> duration);
+
+    PipelineCacheStats GetStats() const;
+
+    operator VkPipelineCache() const
+    {
+        return pipelineCache;
+    }
+
+private:
+    const VulkanContext* vulkanContext = nullptr;
+
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    bool warm = false;
+
+    std::atomic<uint32_t> pipelineCount = 0;
+    std::atomic<float> creationTimeMs = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <future>
+#include <queue>
+
+#include "Engine/Render/Vulkan/Pipelines/Pipeline.hpp"
+
+class VulkanContext;
+
+// Rebuilds pipelines on a worker thread on hot reload while the old ones keep rendering.
+// Owner polls it at the frame boundary, replaced pipelines are retired through the deletion queue
+class PipelineReloader
+{
+public:
+    // Key is defined by the owner, e.g. pipeline index or permutation
+    using KeyedPipelines = std::vector<std::pair<uint32_t, Pipeline>>;
+    using BuildFunction = std::function<KeyedPipelines()>;
+
+    explicit PipelineReloader(const VulkanContext& aVulkanContext);
+    ~PipelineReloader();
+
+    PipelineReloader(const PipelineReloader&) = delete;
+    PipelineReloader& operator=(const PipelineReloader&) = delete;
+
+    PipelineReloader(PipelineReloader&&) = delete;
+    PipelineReloader& operator=(PipelineReloader&&) = delete;
+
+    // Function runs on a worker thread, so it has to be self-contained: handles, layouts and options it needs
+    // are captured by value, only VulkanContext (thread safe shader and pipeline creation) may be captured by
+    // reference, never the owner itself. If previous build is still running, this one is queued. Queued builds
+    // run one after another in order, so a build of a subset of pipelines never drops the earlier requested one
+    void Start(BuildFunction buildFunction);
+
+    // Returns rebuilt pipelines of a single build once they are ready, in the order builds were started.
+    // Invalid ones failed to build and old ones should be kept
+    std::optional<KeyedPipelines> TryTake();
+
+    // Swaps in valid rebuilt pipelines using keys as indices, returns true if any of them got replaced
+    bool TryApply(std::span<Pipeline> pipelines);
+
+    bool IsRunning() const
+    {
+        return future.valid();
+    }
+
+private:
+    const VulkanContext* vulkanContext = nullptr;
+
+    std::future<KeyedPipelines> future;
+    std::queue<BuildFunction> pendingBuildFunctions;
+};
\ No newline at end of file
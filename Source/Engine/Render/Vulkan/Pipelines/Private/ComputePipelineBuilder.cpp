@@ -17,18 +17,27 @@ Pipeline ComputePipelineBuilder::Build() const
 
     const VkPipelineLayout pipelineLayout = CreatePipelineLayout(descriptorSetLayouts, pushConstantRanges, device);
     
+    const VkSpecializationInfo specializationInfo = specializationConstants.GetInfo();
+
     VkComputePipelineCreateInfo pipelineInfo = { .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
     pipelineInfo.stage = shaderModule->GetVkPipelineShaderStageCreateInfo();
+    pipelineInfo.stage.pSpecializationInfo = specializationConstants.IsEmpty() ? nullptr : &specializationInfo;
     pipelineInfo.layout = pipelineLayout;
     
     // Can be used to create pipeline from similar one (which is faster than entirely new one)
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
+    PipelineCache& pipelineCache = vulkanContext->GetPipelineCache();
+
+    const auto creationStart = std::chrono::high_resolution_clock::now();
+
     VkPipeline pipeline;
-    const VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    const VkResult result = vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
     Assert(result == VK_SUCCESS);
 
+    pipelineCache.AddCreationTime(std::chrono::high_resolution_clock::now() - creationStart);
+
     return { pipeline, pipelineLayout, PipelineType::eCompute, *vulkanContext };
 }
 
@@ -49,7 +58,24 @@ ComputePipelineBuilder& ComputePipelineBuilder::AddPushConstantRange(const VkPus
 
 ComputePipelineBuilder& ComputePipelineBuilder::SetShaderModule(ShaderModule&& aShaderModule)
 {
-    shaderModule = std::make_unique<ShaderModule>(std::move(aShaderModule));
+    ownedShaderModule = std::make_unique<ShaderModule>(std::move(aShaderModule));
+    shaderModule = ownedShaderModule.get();
 
     return *this;
 }
+
+ComputePipelineBuilder& ComputePipelineBuilder::SetShaderModule(const ShaderModule& aShaderModule)
+{
+    ownedShaderModule.reset();
+    shaderModule = &aShaderModule;
+
+    return *this;
+}
+
+ComputePipelineBuilder& ComputePipelineBuilder::SetSpecializationConstants(
+    SpecializationConstants aSpecializationConstants)
+{
+    specializationConstants = std::move(aSpecializationConstants);
+
+    return *this;
+}
\ No newline at end of file
@@ -132,13 +132,16 @@ namespace GraphicsPipelineBuilderDetails
     }
 
     static std::vector<VkPipelineShaderStageCreateInfo> GetShaderStageCreateInfos(
-        const std::vector<ShaderModule>& shaders)
+        const std::vector<ShaderModule>& shaders, const VkSpecializationInfo* specializationInfo)
     {
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
         shaderStages.reserve(shaders.size());
 
-        std::ranges::transform(shaders, std::back_inserter(shaderStages), [](const ShaderModule& shader) {
-            return shader.GetVkPipelineShaderStageCreateInfo();
+        std::ranges::transform(shaders, std::back_inserter(shaderStages), [&](const ShaderModule& shader) {
+            VkPipelineShaderStageCreateInfo shaderStage = shader.GetVkPipelineShaderStageCreateInfo();
+            shaderStage.pSpecializationInfo = specializationInfo;
+
+            return shaderStage;
         });
 
         return shaderStages;
@@ -165,13 +168,15 @@ Pipeline GraphicsPipelineBuilder::Build() const
     using namespace VulkanUtils;
 
     Assert(!shaderModules.empty());
-    Assert(renderPass != nullptr);
+    Assert(renderPass != VK_NULL_HANDLE);
     
     const VkDevice device = vulkanContext->GetDevice();
 
     const VkPipelineLayout pipelineLayout = CreatePipelineLayout(descriptorSetLayouts, pushConstantRanges, device);
     
-    const std::vector<VkPipelineShaderStageCreateInfo> shaderStages = GetShaderStageCreateInfos(shaderModules);
+    const VkSpecializationInfo specializationInfo = specializationConstants.GetInfo();
+    const std::vector<VkPipelineShaderStageCreateInfo> shaderStages = GetShaderStageCreateInfos(shaderModules,
+        specializationConstants.IsEmpty() ? nullptr : &specializationInfo);
 
     const std::optional<VkPipelineVertexInputStateCreateInfo> vertexInputInfo
         = GetVertexInputStateCreateInfo(vertexBindings, vertexAttributes);
@@ -190,17 +195,23 @@ Pipeline GraphicsPipelineBuilder::Build() const
     pipelineInfo.pColorBlendState = &colorBlendState;
     pipelineInfo.layout = pipelineLayout;
     pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.renderPass = *renderPass;
+    pipelineInfo.renderPass = renderPass;
     pipelineInfo.subpass = subpass;
 
     // Can be used to create pipeline from similar one (which is faster than entirely new one)
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
+    PipelineCache& pipelineCache = vulkanContext->GetPipelineCache();
+
+    const auto creationStart = std::chrono::high_resolution_clock::now();
+
     VkPipeline pipeline;
-    const VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    const VkResult result = vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
     Assert(result == VK_SUCCESS);
 
+    pipelineCache.AddCreationTime(std::chrono::high_resolution_clock::now() - creationStart);
+
     return { pipeline, pipelineLayout, PipelineType::eGraphics, *vulkanContext };
 }
 
@@ -226,6 +237,14 @@ GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetShaderModules(std::vector<S
     return *this;
 }
 
+GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetSpecializationConstants(
+    SpecializationConstants aSpecializationConstants)
+{
+    specializationConstants = std::move(aSpecializationConstants);
+
+    return *this;
+}
+
 GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetVertexData(VertexBindings bindings, VertexAttributes attributes)
 {
     vertexBindings = std::move(bindings);
@@ -322,10 +341,10 @@ GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetDepthState(const bool depth
     return *this;
 }
 
-GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetRenderPass(const RenderPass& aRenderPass, 
+GraphicsPipelineBuilder& GraphicsPipelineBuilder::SetRenderPass(const VkRenderPass aRenderPass, 
     const uint32_t aSubpass /* = 0 */)
 {
-    renderPass = &aRenderPass;
+    renderPass = aRenderPass;
     subpass = aSubpass;
 
     return *this;
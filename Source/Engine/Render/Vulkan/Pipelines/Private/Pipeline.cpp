@@ -14,15 +14,13 @@ Pipeline::Pipeline(const VkPipeline aPipeline, const VkPipelineLayout aLayout, c
 
 Pipeline::~Pipeline()
 {
-    // TODO: Deletion queue? Don't care now
+    // Pipelines that might be in use by frames in flight have to go through the deletion queue
     if (pipeline != VK_NULL_HANDLE)
     {
         Assert(layout != VK_NULL_HANDLE);
 
         const Device& device = vulkanContext->GetDevice();
 
-        device.WaitIdle();
-
         vkDestroyPipeline(device, pipeline, nullptr);
         vkDestroyPipelineLayout(device, layout, nullptr);
     }
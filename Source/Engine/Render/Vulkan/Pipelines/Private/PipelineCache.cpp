@@ -0,0 +1,164 @@
+#include "Engine/Render/Vulkan/Pipelines/PipelineCache.hpp"
+
+#include "Engine/FileSystem/FileSystem.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+namespace PipelineCacheDetails
+{
+    static constexpr std::string_view cachePath = "~/Cache/PipelineCache.bin";
+
+    static constexpr uint32_t headerMagic = 0x574C5043; // "WLPC"
+
+    // Driver validates its own header too (vendor, device and pipelineCacheUUID), but it's not guaranteed to reject
+    // data from the other driver version, so let's be explicit about it
+    struct CacheFileHeader
+    {
+        uint32_t magic = headerMagic;
+        uint32_t dataSize = 0;
+        uint32_t vendorId = 0;
+        uint32_t deviceId = 0;
+        uint32_t driverVersion = 0;
+        std::array<uint8_t, VK_UUID_SIZE> deviceUuid = {};
+        std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUuid = {};
+    };
+
+    static CacheFileHeader GetExpectedHeader(const Device& device)
+    {
+        VkPhysicalDeviceIDProperties idProperties = { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
+
+        VkPhysicalDeviceProperties2 properties = { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+        properties.pNext = &idProperties;
+
+        vkGetPhysicalDeviceProperties2(device.GetPhysicalDevice(), &properties);
+
+        CacheFileHeader header = {
+            .vendorId = properties.properties.vendorID,
+            .deviceId = properties.properties.deviceID,
+            .driverVersion = properties.properties.driverVersion };
+
+        std::ranges::copy(idProperties.deviceUUID, header.deviceUuid.begin());
+        std::ranges::copy(properties.properties.pipelineCacheUUID, header.pipelineCacheUuid.begin());
+
+        return header;
+    }
+
+    static bool IsHeaderValid(const CacheFileHeader& header, const CacheFileHeader& expected, size_t fileSize)
+    {
+        return header.magic == expected.magic
+            && header.dataSize == fileSize - sizeof(CacheFileHeader)
+            && header.vendorId == expected.vendorId
+            && header.deviceId == expected.deviceId
+            && header.driverVersion == expected.driverVersion
+            && header.deviceUuid == expected.deviceUuid
+            && header.pipelineCacheUuid == expected.pipelineCacheUuid;
+    }
+
+    // Returns driver data only if the file was saved on the same device and driver
+    static std::vector<char> LoadCacheData(const FilePath& path, const Device& device)
+    {
+        if (!path.Exists())
+        {
+            LogI << "Pipeline cache not found, starting cold\n";
+            return {};
+        }
+
+        std::vector<char> fileData = FileSystem::ReadFile(path);
+
+        if (fileData.size() < sizeof(CacheFileHeader))
+        {
+            LogW << "Pipeline cache is corrupted, starting cold\n";
+            return {};
+        }
+
+        CacheFileHeader header;
+        std::memcpy(&header, fileData.data(), sizeof(CacheFileHeader));
+
+        if (!IsHeaderValid(header, GetExpectedHeader(device), fileData.size()))
+        {
+            LogI << "Pipeline cache was saved for another device or driver, starting cold\n";
+            return {};
+        }
+
+        return { fileData.begin() + sizeof(CacheFileHeader), fileData.end() };
+    }
+}
+
+PipelineCache::PipelineCache(const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+{
+    using namespace PipelineCacheDetails;
+
+    const std::vector<char> cacheData = LoadCacheData(FilePath(cachePath), vulkanContext->GetDevice());
+
+    VkPipelineCacheCreateInfo createInfo = { .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    createInfo.initialDataSize = cacheData.size();
+    createInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+    const VkResult result = vkCreatePipelineCache(vulkanContext->GetDevice(), &createInfo, nullptr, &pipelineCache);
+    Assert(result == VK_SUCCESS);
+
+    warm = !cacheData.empty();
+}
+
+PipelineCache::~PipelineCache()
+{
+    Save();
+
+    vkDestroyPipelineCache(vulkanContext->GetDevice(), pipelineCache, nullptr);
+}
+
+void PipelineCache::Save() const
+{
+    using namespace PipelineCacheDetails;
+
+    const VkDevice device = vulkanContext->GetDevice();
+
+    size_t dataSize = 0;
+    VkResult result = vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr);
+    Assert(result == VK_SUCCESS);
+
+    CacheFileHeader header = GetExpectedHeader(vulkanContext->GetDevice());
+    header.dataSize = static_cast<uint32_t>(dataSize);
+
+    std::vector<char> fileData(sizeof(CacheFileHeader) + dataSize);
+    std::memcpy(fileData.data(), &header, sizeof(CacheFileHeader));
+
+    result = vkGetPipelineCacheData(device, pipelineCache, &dataSize, fileData.data() + sizeof(CacheFileHeader));
+    Assert(result == VK_SUCCESS);
+
+    const FilePath path(cachePath);
+    FileSystem::CreateDirectories(path);
+
+    // Write to the temporary file first, so crash in the middle doesn't leave broken cache behind
+    const FilePath tempPath(path.GetAbsolute() + ".tmp");
+
+    {
+        std::ofstream file(tempPath.GetAbsolute(), std::ios::binary | std::ios::trunc);
+        file.write(fileData.data(), static_cast<std::streamsize>(fileData.size()));
+
+        if (!file.good())
+        {
+            LogW << "Failed to save pipeline cache: " << path << '\n';
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath.GetAbsolute(), path.GetAbsolute(), error);
+
+    if (error)
+    {
+        LogW << "Failed to save pipeline cache: " << path << '\n';
+    }
+}
+
+void PipelineCache::AddCreationTime(const std::chrono::duration<float, std::milli> duration)
+{
+    ++pipelineCount;
+    creationTimeMs += duration.count();
+}
+
+PipelineCacheStats PipelineCache::GetStats() const
+{
+    return { .warm = warm, .pipelineCount = pipelineCount, .creationTimeMs = creationTimeMs };
+}
\ No newline at end of file
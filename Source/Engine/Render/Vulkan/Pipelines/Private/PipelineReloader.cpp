@@ -0,0 +1,64 @@
+#include "Engine/Render/Vulkan/Pipelines/PipelineReloader.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+PipelineReloader::PipelineReloader(const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+{}
+
+// Future from std::async joins the worker, its pipelines are never used by the gpu so they are destroyed right away
+PipelineReloader::~PipelineReloader() = default;
+
+void PipelineReloader::Start(BuildFunction buildFunction)
+{
+    if (future.valid())
+    {
+        pendingBuildFunctions.push(std::move(buildFunction));
+        return;
+    }
+
+    future = std::async(std::launch::async, std::move(buildFunction));
+}
+
+std::optional<PipelineReloader::KeyedPipelines> PipelineReloader::TryTake()
+{
+    if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return std::nullopt;
+    }
+
+    KeyedPipelines pipelines = future.get();
+
+    if (!pendingBuildFunctions.empty())
+    {
+        future = std::async(std::launch::async, std::move(pendingBuildFunctions.front()));
+        pendingBuildFunctions.pop();
+    }
+
+    return pipelines;
+}
+
+bool PipelineReloader::TryApply(std::span<Pipeline> pipelines)
+{
+    std::optional<KeyedPipelines> newPipelines = TryTake();
+
+    if (!newPipelines)
+    {
+        return false;
+    }
+
+    bool applied = false;
+
+    for (auto& [index, newPipeline] : *newPipelines)
+    {
+        Assert(index < pipelines.size());
+
+        if (newPipeline.IsValid())
+        {
+            vulkanContext->GetDeletionQueue().Enqueue(std::exchange(pipelines[index], std::move(newPipeline)));
+            applied = true;
+        }
+    }
+
+    return applied;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "Engine/Render/Vulkan/Pipelines/SpecializationConstants.hpp"
+
+SpecializationConstants& SpecializationConstants::Set(const uint32_t id, const uint32_t value)
+{
+    const auto it = std::ranges::find(entries, id, &VkSpecializationMapEntry::constantID);
+
+    if (it != entries.end())
+    {
+        data[std::distance(entries.begin(), it)] = value;
+        return *this;
+    }
+
+    entries.push_back({ id, static_cast<uint32_t>(data.size() * sizeof(uint32_t)), sizeof(uint32_t) });
+    data.push_back(value);
+
+    return *this;
+}
+
+VkSpecializationInfo SpecializationConstants::GetInfo() const
+{
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(entries.size());
+    info.pMapEntries = entries.data();
+    info.dataSize = data.size() * sizeof(uint32_t);
+    info.pData = data.data();
+
+    return info;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <volk.h>
+
+// Values for shader constant_id constants, ids shared by all of the pipeline stages.
+// Ids a stage doesn't declare are ignored by it, booleans are passed as VkBool32
+class SpecializationConstants
+{
+public:
+    SpecializationConstants& Set(uint32_t id, uint32_t value);
+
+    // Points to the data of this object, so it has to stay alive until the pipeline is created
+    VkSpecializationInfo GetInfo() const;
+
+    bool IsEmpty() const
+    {
+        return entries.empty();
+    }
+
+private:
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<uint32_t> data;
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "Engine/Render/Vulkan/CommandRecorder.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+namespace CommandRecorderDetails
+{
+    static VkCommandPool CreateCommandPool(const VulkanContext& vulkanContext)
+    {
+        const Device& device = vulkanContext.GetDevice();
+
+        VkCommandPoolCreateInfo poolInfo = { .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = device.GetQueues().familyIndices.graphicsAndComputeFamily;
+
+        VkCommandPool commandPool;
+        const VkResult result = vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool);
+        Assert(result == VK_SUCCESS);
+
+        return commandPool;
+    }
+
+    static VkCommandBuffer CreateSecondaryCommandBuffer(VkDevice device, VkCommandPool commandPool)
+    {
+        VkCommandBufferAllocateInfo allocInfo = { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        const VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+        Assert(result == VK_SUCCESS);
+
+        return commandBuffer;
+    }
+}
+
+CommandRecorder::CommandRecorder(const VkQueryPipelineStatisticFlags aInheritedStatistics, const bool aReusable,
+    const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+    , inheritedStatistics{ aInheritedStatistics }
+    , reusable{ aReusable }
+{}
+
+CommandRecorder::~CommandRecorder()
+{
+    std::ranges::for_each(workers, [&](Worker& worker) {
+        if (worker.recording.valid())
+        {
+            worker.recording.wait();
+        }
+
+        vkDestroyCommandPool(vulkanContext->GetDevice(), worker.commandPool, nullptr);
+    });
+}
+
+void CommandRecorder::Reset()
+{
+    Assert(reusable || commands.empty());
+
+    commands.clear();
+
+    for (uint32_t i = 0; i < usedWorkersCount; ++i)
+    {
+        const VkResult result = vkResetCommandPool(vulkanContext->GetDevice(), workers[i].commandPool, 0);
+        Assert(result == VK_SUCCESS);
+    }
+
+    usedWorkersCount = 0;
+}
+
+void CommandRecorder::Record(DeviceCommands aCommands)
+{
+    commands.push_back(std::move(aCommands));
+}
+
+void CommandRecorder::RecordSecondary(DeviceCommands aCommands, VkRenderPass renderPass, VkFramebuffer framebuffer)
+{
+    using namespace CommandRecorderDetails;
+
+    if (usedWorkersCount == workers.size())
+    {
+        Worker& worker = workers.emplace_back();
+        worker.commandPool = CreateCommandPool(*vulkanContext);
+        worker.commandBuffer = CreateSecondaryCommandBuffer(vulkanContext->GetDevice(), worker.commandPool);
+    }
+
+    const uint32_t workerIndex = usedWorkersCount++;
+    const VkCommandBuffer commandBuffer = workers[workerIndex].commandBuffer;
+
+    const VkCommandBufferInheritanceInfo inheritanceInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .renderPass = renderPass,
+        .subpass = 0,
+        .framebuffer = framebuffer,
+        .pipelineStatistics = inheritedStatistics };
+
+    const VkCommandBufferUsageFlags usageFlags = reusable ? 0 : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    const auto recordCommands = [=, deviceCommands = std::move(aCommands)]() {
+        VkCommandBufferBeginInfo beginInfo = { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        beginInfo.flags = usageFlags;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        if (renderPass != VK_NULL_HANDLE)
+        {
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        }
+
+        VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        Assert(result == VK_SUCCESS);
+
+        deviceCommands(commandBuffer);
+
+        result = vkEndCommandBuffer(commandBuffer);
+        Assert(result == VK_SUCCESS);
+    };
+
+    workers[workerIndex].recording = vulkanContext->GetThreadPool().Submit(recordCommands);
+
+    commands.emplace_back([this, workerIndex](VkCommandBuffer primaryCommandBuffer) {
+        workers[workerIndex].recording.wait();
+        vkCmdExecuteCommands(primaryCommandBuffer, 1, &workers[workerIndex].commandBuffer);
+    });
+}
+
+void CommandRecorder::Append(const CommandRecorder& recorder)
+{
+    commands.emplace_back([&recorder](VkCommandBuffer commandBuffer) {
+        recorder.Replay(commandBuffer);
+    });
+}
+
+void CommandRecorder::Flush(VkCommandBuffer commandBuffer)
+{
+    Replay(commandBuffer);
+
+    commands.clear();
+}
+
+void CommandRecorder::Replay(VkCommandBuffer commandBuffer) const
+{
+    std::ranges::for_each(commands, [&](const DeviceCommands& deviceCommands) {
+        deviceCommands(commandBuffer);
+    });
+}
\ No newline at end of file
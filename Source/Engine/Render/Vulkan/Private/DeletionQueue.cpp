@@ -1,49 +1,106 @@
-//#include "Engine/Render/Vulkan/DeletionQueue.hpp"
-//
-//#include "Engine/Render/Vulkan/VulkanContext.hpp"
-//
-//DeletionQueue::DeletionQueue(const VulkanContext& aVulkanContext)
-//    : vulkanContext{ &aVulkanContext }
-//{
-//    
-//}
-//
-//DeletionQueue::~DeletionQueue()
-//{
-//    Assert(images.empty());
-//}
-//
-//DeletionQueue::DeletionQueue(DeletionQueue&& other) noexcept
-//    : vulkanContext{ other.vulkanContext }
-//    , images{ std::move(other.images) }
-//{
-//    other.vulkanContext = nullptr;
-//}
-//
-//DeletionQueue& DeletionQueue::operator=(DeletionQueue&& other) noexcept
-//{
-//    if (this != &other)
-//    {
-//        std::swap(vulkanContext, other.vulkanContext);
-//        std::swap(images, other.images);
-//    }
-//    return *this;
-//}
-//
-//void DeletionQueue::Flush()
-//{
-//    MemoryManager& memoryManager = vulkanContext->GetMemoryManager();
-//    
-//    const auto destroyImage = [&](const Image& image) {
-//        memoryManager.DestroyImage(image.Get());
-//    };
-//    
-//    std::ranges::for_each(images, destroyImage);
-//    images.clear();
-//}
-//
-//void DeletionQueue::Add(Image image)
-//{
-//    images.push_back(std::move(image));
-//    
-//}
+#include "Engine/Render/Vulkan/DeletionQueue.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+DeletionQueue::DeletionQueue(const VulkanContext& aVulkanContext)
+    : vulkanContext{ &aVulkanContext }
+{}
+
+DeletionQueue::~DeletionQueue()
+{
+    vulkanContext->GetDevice().WaitIdle();
+
+    std::ranges::for_each(frameResources, [&](FrameResources& resources) { Destroy(resources); });
+}
+
+void DeletionQueue::Flush(const uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    Destroy(frameResources[currentFrame]);
+}
+
+void DeletionQueue::Enqueue(Buffer&& buffer)
+{
+    frameResources[currentFrame].buffers.push_back(std::move(buffer));
+}
+
+void DeletionQueue::Enqueue(Image&& image)
+{
+    frameResources[currentFrame].images.push_back(std::move(image));
+}
+
+void DeletionQueue::Enqueue(ImageView&& imageView)
+{
+    frameResources[currentFrame].imageViews.push_back(std::move(imageView));
+}
+
+void DeletionQueue::Enqueue(RenderTarget&& renderTarget)
+{
+    Enqueue(std::move(renderTarget.view));
+    Enqueue(std::move(renderTarget.image));
+}
+
+void DeletionQueue::Enqueue(Pipeline&& pipeline)
+{
+    frameResources[currentFrame].pipelines.push_back(std::move(pipeline));
+}
+
+void DeletionQueue::Enqueue(RenderPass&& renderPass)
+{
+    frameResources[currentFrame].renderPasses.push_back(std::move(renderPass));
+}
+
+void DeletionQueue::Enqueue(DescriptorSetPool&& pool)
+{
+    frameResources[currentFrame].descriptorPools.push_back(std::move(pool));
+}
+
+void DeletionQueue::Enqueue(VkBuffer buffer)
+{
+    frameResources[currentFrame].bufferHandles.push_back(buffer);
+}
+
+void DeletionQueue::Enqueue(VkFramebuffer framebuffer)
+{
+    frameResources[currentFrame].framebuffers.push_back(framebuffer);
+}
+
+void DeletionQueue::Enqueue(std::vector<VkFramebuffer>& framebuffers)
+{
+    std::ranges::copy(framebuffers, std::back_inserter(frameResources[currentFrame].framebuffers));
+    framebuffers.clear();
+}
+
+void DeletionQueue::Enqueue(VkSwapchainKHR swapchain)
+{
+    frameResources[currentFrame].swapchains.push_back(swapchain);
+}
+
+void DeletionQueue::Destroy(FrameResources& resources) const
+{
+    const VkDevice device = vulkanContext->GetDevice();
+
+    // Views first, they reference images
+    resources.imageViews.clear();
+    resources.images.clear();
+    resources.buffers.clear();
+    resources.pipelines.clear();
+    resources.renderPasses.clear();
+    resources.descriptorPools.clear();
+
+    std::ranges::for_each(resources.bufferHandles, [&](VkBuffer buffer) {
+        vkDestroyBuffer(device, buffer, nullptr);
+    });
+    resources.bufferHandles.clear();
+
+    std::ranges::for_each(resources.framebuffers, [&](VkFramebuffer framebuffer) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    });
+    resources.framebuffers.clear();
+
+    std::ranges::for_each(resources.swapchains, [&](VkSwapchainKHR swapchain) {
+        vkDestroySwapchainKHR(device, swapchain, nullptr);
+    });
+    resources.swapchains.clear();
+}
\ No newline at end of file
@@ -103,9 +103,28 @@ namespace DeviceDetails
         return queues;
     }
     
+    // Optional in Vulkan 1.2, but bindless textures can't work without it, see BindlessTextureSet
+    static bool IsDescriptorIndexingSupported(const VkPhysicalDevice physicalDevice)
+    {
+        VkPhysicalDeviceVulkan12Features features12 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+
+        VkPhysicalDeviceFeatures2 features2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &features12 };
+
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+        return features12.descriptorIndexing && features12.shaderSampledImageArrayNonUniformIndexing
+            && features12.descriptorBindingSampledImageUpdateAfterBind
+            && features12.descriptorBindingUpdateUnusedWhilePending && features12.descriptorBindingPartiallyBound
+            && features12.runtimeDescriptorArray;
+    }
+
     static bool IsPhysicalDeviceSuitable(VkPhysicalDevice device)
     {
-        return ExtensionsSupported(device, std::span(VulkanConfig::requiredDeviceExtensions));
+        return ExtensionsSupported(device, std::span(VulkanConfig::requiredDeviceExtensions))
+            && IsDescriptorIndexingSupported(device);
     }
 
     // TODO: (low priority) device selection based on some kind of score (do i really need this?)
@@ -172,7 +191,8 @@ namespace DeviceDetails
         VkPhysicalDeviceFeatures deviceFeatures = {
             .multiDrawIndirect = VK_TRUE,
             .samplerAnisotropy = VK_TRUE,
-            .pipelineStatisticsQuery = VK_TRUE };
+            .pipelineStatisticsQuery = VK_TRUE,
+            .inheritedQueries = VK_TRUE };
 
         VkPhysicalDeviceVulkan11Features deviceFeatures11 = {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
@@ -185,11 +205,24 @@ namespace DeviceDetails
             .pNext = &deviceFeatures11,
             .drawIndirectCount = VK_TRUE,
             .storageBuffer8BitAccess = VK_TRUE,
-            .shaderInt8 = VK_TRUE };
+            .shaderInt8 = VK_TRUE,
+            .descriptorIndexing = VK_TRUE,
+            .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+            .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+            .descriptorBindingPartiallyBound = VK_TRUE,
+            .runtimeDescriptorArray = VK_TRUE,
+            .timelineSemaphore = VK_TRUE,
+            .bufferDeviceAddress = VK_TRUE };
+
+        VkPhysicalDeviceVulkan13Features deviceFeatures13 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+            .pNext = &deviceFeatures12,
+            .synchronization2 = VK_TRUE };
 
         VkPhysicalDeviceFeatures2 deviceFeatures2 = {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-            .pNext = &deviceFeatures12,
+            .pNext = &deviceFeatures13,
             .features = deviceFeatures };
 
         std::vector enabledExtensions(requiredDeviceExtensions.begin(), requiredDeviceExtensions.end());
@@ -199,6 +232,11 @@ namespace DeviceDetails
             enabledExtensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
         }
 
+        if (properties.memoryBudgetSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
         VkDeviceCreateInfo createInfo = {
             .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
             .pNext = &deviceFeatures2,
@@ -228,10 +266,15 @@ namespace DeviceDetails
         return commandPool;
     }
 
-    static VkSampleCountFlagBits GetMaxSampleCount(const VkPhysicalDeviceProperties& physicalDeviceProperties)
+    static VkSampleCountFlags GetSupportedSampleCounts(const VkPhysicalDeviceProperties& physicalDeviceProperties)
     {
-        VkSampleCountFlags counts = physicalDeviceProperties.limits.framebufferColorSampleCounts &
+        return physicalDeviceProperties.limits.framebufferColorSampleCounts &
             physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+    }
+
+    static VkSampleCountFlagBits GetMaxSampleCount(const VkPhysicalDeviceProperties& physicalDeviceProperties)
+    {
+        VkSampleCountFlags counts = GetSupportedSampleCounts(physicalDeviceProperties);
 
         std::array countsToConsider = { VK_SAMPLE_COUNT_64_BIT, VK_SAMPLE_COUNT_32_BIT, VK_SAMPLE_COUNT_16_BIT,
             VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT };
@@ -242,6 +285,18 @@ namespace DeviceDetails
 
         return result != countsToConsider.end() ? *result : VK_SAMPLE_COUNT_1_BIT;
     }
+
+    static bool IsLazilyAllocatedMemorySupported(const VkPhysicalDevice physicalDevice)
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        const auto memoryTypes = std::span(memoryProperties.memoryTypes, memoryProperties.memoryTypeCount);
+
+        return std::ranges::any_of(memoryTypes, [](const VkMemoryType& memoryType) {
+            return (memoryType.propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+        });
+    }
 }
 
 Device::Device(const VulkanContext& aVulkanContext)
@@ -266,7 +321,7 @@ Device::Device(const VulkanContext& aVulkanContext)
         VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, queues.familyIndices.graphicsAndComputeFamily));
 
     oneTimeCommandBuffer = VulkanUtils::CreateCommandBuffers(device, 1, commandPools[CommandBufferType::eOneTime])[0];
-    oneTimeCommandBufferSync = CommandBufferSync{ {}, {}, {}, VulkanUtils::CreateFence(device, {}), device };
+    oneTimeCommandBufferSync = CommandBufferSync{ {}, {}, {}, VulkanUtils::CreateTimelineSemaphore(device), device };
 }
 
 Device::~Device()
@@ -295,11 +350,7 @@ void Device::ExecuteOneTimeCommandBuffer(const DeviceCommands& commands) const
 {
     VulkanUtils::SubmitCommandBuffer(oneTimeCommandBuffer, queues.graphicsAndCompute, commands, oneTimeCommandBufferSync);
 
-    VkFence fence = oneTimeCommandBufferSync.GetFence();
-    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
-
-    const VkResult result = vkResetFences(device, 1, &fence);
-    Assert(result == VK_SUCCESS);
+    oneTimeCommandBufferSync.Wait();
 }
 
 void Device::InitProperties()
@@ -309,5 +360,9 @@ void Device::InitProperties()
     std::vector<VkExtensionProperties> availableExtensionsProperties = GetExtensionsProperties(physicalDevice);
     
     properties.maxSampleCount = GetMaxSampleCount(properties.physicalProperties);
+    properties.supportedSampleCounts = GetSupportedSampleCounts(properties.physicalProperties);
+    properties.lazilyAllocatedMemorySupported = IsLazilyAllocatedMemorySupported(physicalDevice);
     properties.meshShadersSupported = ExtensionSupported(availableExtensionsProperties, VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    properties.memoryBudgetSupported = ExtensionSupported(availableExtensionsProperties,
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 }
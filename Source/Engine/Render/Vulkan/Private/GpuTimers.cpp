@@ -0,0 +1,71 @@
+#include "Engine/Render/Vulkan/GpuTimers.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+namespace GpuTimersDetails
+{
+    static uint32_t GetQueryIndex(const uint32_t frameIndex, const GpuTimer timer, const bool end)
+    {
+        return frameIndex * GpuTimers::queryCountPerFrame + static_cast<uint32_t>(timer) * 2 + (end ? 1 : 0);
+    }
+}
+
+VkQueryPool GpuTimers::CreateQueryPool(const VulkanContext& vulkanContext)
+{
+    VkQueryPoolCreateInfo queryPoolInfo = { .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = queryCountPerFrame * VulkanConfig::maxFramesInFlight;
+
+    VkQueryPool queryPool;
+    const VkResult result = vkCreateQueryPool(vulkanContext.GetDevice(), &queryPoolInfo, nullptr, &queryPool);
+    Assert(result == VK_SUCCESS);
+
+    vulkanContext.GetDevice().ExecuteOneTimeCommandBuffer([&](const VkCommandBuffer cmd) {
+        vkCmdResetQueryPool(cmd, queryPool, 0, queryPoolInfo.queryCount);
+    });
+
+    return queryPool;
+}
+
+void GpuTimers::Reset(const VkCommandBuffer commandBuffer, const VkQueryPool queryPool, const uint32_t frameIndex)
+{
+    vkCmdResetQueryPool(commandBuffer, queryPool, frameIndex * queryCountPerFrame, queryCountPerFrame);
+}
+
+void GpuTimers::Begin(const VkCommandBuffer commandBuffer, const VkQueryPool queryPool, const uint32_t frameIndex,
+    const GpuTimer timer)
+{
+    vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_NONE, queryPool,
+        GpuTimersDetails::GetQueryIndex(frameIndex, timer, false));
+}
+
+void GpuTimers::End(const VkCommandBuffer commandBuffer, const VkQueryPool queryPool, const uint32_t frameIndex,
+    const GpuTimer timer)
+{
+    vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, queryPool,
+        GpuTimersDetails::GetQueryIndex(frameIndex, timer, true));
+}
+
+void GpuTimers::GetResults(const VulkanContext& vulkanContext, const VkQueryPool queryPool, const uint32_t frameIndex,
+    const std::span<float, timerCount> timesMs)
+{
+    // Value + availability for every query
+    std::array<uint64_t, queryCountPerFrame * 2> results = {};
+
+    const VkResult result = vkGetQueryPoolResults(vulkanContext.GetDevice(), queryPool,
+        frameIndex * queryCountPerFrame, queryCountPerFrame, sizeof(results), results.data(), sizeof(uint64_t) * 2,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    Assert(result == VK_SUCCESS || result == VK_NOT_READY);
+
+    const float timestampPeriod = vulkanContext.GetDevice().GetProperties().physicalProperties.limits.timestampPeriod;
+
+    for (uint32_t i = 0; i < timerCount; ++i)
+    {
+        const uint64_t begin = results[i * 4];
+        const uint64_t end = results[i * 4 + 2];
+        const bool available = results[i * 4 + 1] != 0 && results[i * 4 + 3] != 0;
+
+        timesMs[i] = available && end > begin
+            ? static_cast<float>(end - begin) * timestampPeriod / 1'000'000.0f : 0.0f;
+    }
+}
\ No newline at end of file
@@ -120,7 +120,8 @@ namespace SwapchainDetails
     }
 
     static VkSwapchainKHR CreateSwapchain(const VulkanContext& vulkanContext, const SwapchainSupportDetails& supportDetails, 
-        const VkSurfaceCapabilitiesKHR& capabilities, const VkSurfaceFormatKHR surfaceFormat, const VkExtent2D extent)
+        const VkSurfaceCapabilitiesKHR& capabilities, const VkSurfaceFormatKHR surfaceFormat, const VkExtent2D extent,
+        VkSwapchainKHR oldSwapchain)
     {
         VkSwapchainCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -152,8 +153,7 @@ namespace SwapchainDetails
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode = SelectPresentMode(supportDetails.presentModes);
         createInfo.clipped = VK_TRUE;
-        // TODO: Create swapchain with the use of the old one
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = oldSwapchain;
 
         VkSwapchainKHR swapchain;
         const VkResult result = vkCreateSwapchainKHR(vulkanContext.GetDevice(), &createInfo, nullptr, &swapchain);
@@ -207,18 +207,29 @@ Swapchain::~Swapchain()
 
 void Swapchain::Recreate(const VkExtent2D& requiredExtentInPixels)
 {
-    Cleanup();
-    Create(requiredExtentInPixels);
+    // Old swapchain images might still be used by the frames in flight
+    DeletionQueue& deletionQueue = vulkanContext.GetDeletionQueue();
+
+    std::ranges::for_each(renderTargets, [&](RenderTarget& renderTarget) {
+        deletionQueue.Enqueue(std::move(renderTarget));
+    });
+    renderTargets.clear();
+
+    const VkSwapchainKHR oldSwapchain = swapchain;
+
+    Create(requiredExtentInPixels, oldSwapchain);
+
+    deletionQueue.Enqueue(oldSwapchain);
 }
 
-void Swapchain::Create(const VkExtent2D& requiredExtentInPixels)
+void Swapchain::Create(const VkExtent2D& requiredExtentInPixels, VkSwapchainKHR oldSwapchain)
 {
     using namespace SwapchainDetails;
 
     const VkSurfaceCapabilitiesKHR surfaceCapabilities = GetSurfaceCapabilities(vulkanContext);
     extent = SelectExtent(surfaceCapabilities, requiredExtentInPixels);
 
-    swapchain = CreateSwapchain(vulkanContext, supportDetails, surfaceCapabilities, surfaceFormat, extent);
+    swapchain = CreateSwapchain(vulkanContext, supportDetails, surfaceCapabilities, surfaceFormat, extent, oldSwapchain);
 
     renderTargets = CreateRenderTargets(swapchain, GetRenderTargetDescription(), vulkanContext);
 }
@@ -29,14 +29,19 @@ VulkanContext::VulkanContext(const Window& window, EventSystem& aEventSystem)
         volkInitialized = true;
     }
 
+    // One thread is left for the render thread itself
+    threadPool = std::make_unique<ThreadPool>(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
     instance = std::make_unique<Instance>();
     surface = std::make_unique<Surface>(window, *this);
     device = std::make_unique<Device>(*this);
     swapchain = std::make_unique<Swapchain>(ToVkExtent2D(window.GetExtentInPixels()), *this);
+    pipelineCache = std::make_unique<PipelineCache>(*this);
 
     memoryManager = std::make_unique<MemoryManager>(*this);
     shaderManager = std::make_unique<ShaderManager>(*this);
     descriptorSetsManager = std::make_unique<DescriptorSetManager>(*this);
+    deletionQueue = std::make_unique<DeletionQueue>(*this);
     
     RenderOptions::Initialize(*this, eventSystem);
 
@@ -49,6 +54,9 @@ VulkanContext::~VulkanContext()
 {
     eventSystem.UnsubscribeAll(this);
 
+    // Moved buffers are destroyed with the deletion queue, so the pass has to end first
+    memoryManager->EndDefragmentation();
+
     RenderOptions::Deinitialize();
 }
 
@@ -59,8 +67,7 @@ void VulkanContext::OnResize(const ES::WindowResized& event)
         return;
     }
     
-    device->WaitIdle();
-    
+    // No need to wait for the device, resources that might be in use are passed to the deletion queue
     eventSystem.Fire<ES::BeforeSwapchainRecreated>();
     
     swapchain->Recreate(VulkanContextDetails::ToVkExtent2D(event.newExtent));
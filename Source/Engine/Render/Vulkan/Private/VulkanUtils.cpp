@@ -25,9 +25,9 @@ std::vector<VkCommandBuffer> VulkanUtils::CreateCommandBuffers(VkDevice device,
 }
 
 void VulkanUtils::SubmitCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, const DeviceCommands& commands,
-    const CommandBufferSync& sync)
+    CommandBufferSync& sync)
 {
-    const auto& [waitSemaphores, waitStages, signalSemaphores, fence] = sync.AsTuple();
+    const auto& [waitSemaphores, waitStages, signalSemaphores, timelineSemaphore] = sync.AsTuple();
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -35,22 +35,48 @@ void VulkanUtils::SubmitCommandBuffer(VkCommandBuffer commandBuffer, VkQueue que
 
     // FYI: if buffer was created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT flag vkBeginCommandBuffer
     // implicitly resets the buffer to the initial state
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    Assert(result == VK_SUCCESS);
+
     commands(commandBuffer);
-    VkResult result = vkEndCommandBuffer(commandBuffer);
+
+    result = vkEndCommandBuffer(commandBuffer);
     Assert(result == VK_SUCCESS);
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
-    submitInfo.pWaitSemaphores = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages.data();
-    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
-    submitInfo.pSignalSemaphores = signalSemaphores.data();
-
-    result = vkQueueSubmit(queue, 1, &submitInfo, fence);
+    std::vector<VkSemaphoreSubmitInfo> waitInfos;
+    waitInfos.reserve(waitSemaphores.size());
+
+    for (size_t i = 0; i < waitSemaphores.size(); ++i)
+    {
+        waitInfos.push_back({ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = waitSemaphores[i], .stageMask = waitStages[i] });
+    }
+
+    std::vector<VkSemaphoreSubmitInfo> signalInfos;
+    signalInfos.reserve(signalSemaphores.size() + 1);
+
+    std::ranges::transform(signalSemaphores, std::back_inserter(signalInfos), [](VkSemaphore semaphore) {
+        return VkSemaphoreSubmitInfo{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = semaphore, .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT };
+    });
+
+    signalInfos.push_back({ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = timelineSemaphore, .value = sync.AdvanceTimeline(),
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT });
+
+    const VkCommandBufferSubmitInfo commandBufferInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = commandBuffer };
+
+    VkSubmitInfo2 submitInfo = { .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+    submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
+    submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+    submitInfo.commandBufferInfoCount = 1;
+    submitInfo.pCommandBufferInfos = &commandBufferInfo;
+    submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size());
+    submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+
+    result = vkQueueSubmit2(queue, 1, &submitInfo, VK_NULL_HANDLE);
     Assert(result == VK_SUCCESS);
 }
 
@@ -122,6 +148,42 @@ void VulkanUtils::DestroySemaphores(VkDevice device, std::vector<VkSemaphore>& s
     semaphores.clear();
 }
 
+VkSemaphore VulkanUtils::CreateTimelineSemaphore(VkDevice device, const uint64_t initialValue)
+{
+    VkSemaphoreTypeCreateInfo typeInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = initialValue;
+
+    VkSemaphoreCreateInfo semaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkSemaphore semaphore;
+    const VkResult result = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore);
+    Assert(result == VK_SUCCESS);
+
+    return semaphore;
+}
+
+void VulkanUtils::WaitSemaphore(VkDevice device, VkSemaphore timelineSemaphore, const uint64_t value)
+{
+    VkSemaphoreWaitInfo waitInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timelineSemaphore;
+    waitInfo.pValues = &value;
+
+    const VkResult result = vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+    Assert(result == VK_SUCCESS);
+}
+
+uint64_t VulkanUtils::GetSemaphoreValue(VkDevice device, VkSemaphore timelineSemaphore)
+{
+    uint64_t value;
+    const VkResult result = vkGetSemaphoreCounterValue(device, timelineSemaphore, &value);
+    Assert(result == VK_SUCCESS);
+
+    return value;
+}
+
 VkFramebuffer VulkanUtils::CreateFrameBuffer(const RenderPass& renderPass, const VkExtent2D extent,
     const std::vector<VkImageView>& attachments, const VulkanContext& vulkanContext)
 {
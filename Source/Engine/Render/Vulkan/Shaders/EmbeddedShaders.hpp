@@ -0,0 +1,19 @@
+#pragma once
+
+// Spirv compiled from Source/Shaders at build time, see EMBED_SHADERS in CMakeLists.txt
+namespace EmbeddedShaders
+{
+    struct Entry
+    {
+        std::string_view name; // Relative to the shaders dir, e.g. "Culling/PrimitiveCull.comp"
+        std::span<const uint32_t> spirv;
+    };
+
+    // Defined in the generated source sorted by name, empty if shaders aren't embedded
+    std::span<const Entry> GetEntries();
+
+    bool IsEnabled();
+
+    // Empty if the shader isn't embedded
+    std::span<const uint32_t> Find(std::string_view name);
+}
\ No newline at end of file
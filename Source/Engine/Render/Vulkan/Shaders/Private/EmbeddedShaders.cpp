@@ -0,0 +1,22 @@
+#include "Engine/Render/Vulkan/Shaders/EmbeddedShaders.hpp"
+
+#ifndef EMBED_SHADERS
+std::span<const EmbeddedShaders::Entry> EmbeddedShaders::GetEntries()
+{
+    return {};
+}
+#endif
+
+bool EmbeddedShaders::IsEnabled()
+{
+    return !GetEntries().empty();
+}
+
+std::span<const uint32_t> EmbeddedShaders::Find(const std::string_view name)
+{
+    const std::span<const Entry> entries = GetEntries();
+
+    const auto it = std::ranges::lower_bound(entries, name, {}, &Entry::name);
+
+    return it != entries.end() && it->name == name ? it->spirv : std::span<const uint32_t>();
+}
\ No newline at end of file
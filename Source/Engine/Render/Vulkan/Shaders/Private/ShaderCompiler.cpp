@@ -3,15 +3,22 @@
 DISABLE_WARNINGS_BEGIN
 #include <glslang/Public/ResourceLimits.h>
 #include <SPIRV/GlslangToSpv.h>
+#include <SPIRV/SpvTools.h>
 #include <StandAlone/DirStackFileIncluder.h>
 DISABLE_WARNINGS_END
 
+#include <mutex>
+#include <atomic>
+
 #include "Engine/FileSystem/FileSystem.hpp"
 #include "Engine/Render/Vulkan/VulkanConfig.hpp"
 
 namespace ShaderCompilerDetails
 {
-    static bool initialized = false;
+    // glslang process has to be initialized once before any compilation, compilation itself is thread-safe
+    static std::mutex initializationMutex;
+    static uint32_t compilerCount = 0;
+    static std::atomic<bool> initialized = false;
 
     static std::unordered_map<ShaderType, EShLanguage> glslangStages = {
         { ShaderType::eVertex, EShLangVertex },
@@ -20,28 +27,43 @@ namespace ShaderCompilerDetails
         { ShaderType::eTask, EShLangTask },
         { ShaderType::eMesh, EShLangMesh },
     };
+
+    // Everything Compile passes to glslang, keep in sync with the offline compilation in CMakeLists.txt
+    static constexpr int glslVersion = 100;
+    static constexpr glslang::EShTargetClientVersion clientVersion = glslang::EShTargetVulkan_1_3;
+    static constexpr glslang::EShTargetLanguageVersion spirvVersion = glslang::EShTargetSpv_1_5;
+    static constexpr auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+    static constexpr bool optimizeSize = true; // Offline compilation passes -Os
 }
 
 ShaderCompiler::ShaderCompiler()
 {
-    if (!ShaderCompilerDetails::initialized)
+    using namespace ShaderCompilerDetails;
+
+    std::scoped_lock lock(initializationMutex);
+
+    if (compilerCount++ == 0)
     {
         glslang::InitializeProcess();
-        ShaderCompilerDetails::initialized = true;
+        initialized = true;
     }
 }
 
 ShaderCompiler::~ShaderCompiler()
 {
-    if (ShaderCompilerDetails::initialized)
+    using namespace ShaderCompilerDetails;
+
+    std::scoped_lock lock(initializationMutex);
+
+    if (--compilerCount == 0)
     {
         glslang::FinalizeProcess();
-        ShaderCompilerDetails::initialized = false;
+        initialized = false;
     }
 }
 
-std::vector<uint32_t> ShaderCompiler::Compile(const std::string_view glslCode, const ShaderType shaderType,
-    const FilePath& includeDir)
+std::vector<uint32_t> ShaderCompiler::Compile(const FilePath& path, const std::string_view glslCode,
+    const ShaderType shaderType, const FilePath& includeDir, [[maybe_unused]] const bool optimize)
 {
     using namespace ShaderCompilerDetails;
     
@@ -56,22 +78,26 @@ std::vector<uint32_t> ShaderCompiler::Compile(const std::string_view glslCode, c
     const char* code = glslCode.data();
     const auto length = static_cast<int>(glslCode.size());
 
+    // Includer resolves local includes relative to the including file first, so the source needs its real path
+    const std::string sourcePath = path.GetAbsolute();
+    const char* sourceName = sourcePath.c_str();
+
     glslang::TShader shader(stage);
 
-    shader.setStringsWithLengths(&code, &length, 1);
-    shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, 100);
-    shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_3);
-    shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+    shader.setStringsWithLengthsAndNames(&code, &length, &sourceName, 1);
+    shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, glslVersion);
+    shader.setEnvClient(glslang::EShClientVulkan, clientVersion);
+    shader.setEnvTarget(glslang::EShTargetSpv, spirvVersion);
 
+    // Fallback for includes which aren't found next to the including file
     DirStackFileIncluder includer;
 
     Assert(includeDir.IsDirectory());
     includer.pushExternalLocalDirectory(includeDir.GetAbsolute());
 
     const TBuiltInResource* defaultResources = GetDefaultResources();
-    constexpr auto defaultMessages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
 
-    bool result = shader.parse(defaultResources, 100, false, defaultMessages, includer);
+    bool result = shader.parse(defaultResources, glslVersion, false, messages, includer);
 
     if (!result)
     {
@@ -82,7 +108,7 @@ std::vector<uint32_t> ShaderCompiler::Compile(const std::string_view glslCode, c
     glslang::TProgram program;
     program.addShader(&shader);
 
-    result = program.link(defaultMessages);
+    result = program.link(messages);
 
     if (!result)
     {
@@ -92,13 +118,46 @@ std::vector<uint32_t> ShaderCompiler::Compile(const std::string_view glslCode, c
     
     std::vector<uint32_t> spirv;
     spv::SpvBuildLogger logger;
+
+    // Optimizer is run separately to report the size it saves
+    glslang::SpvOptions spvOptions;
+    spvOptions.disableOptimizer = true;
     
-    GlslangToSpv(*program.getIntermediate(stage), spirv, &logger);
+    GlslangToSpv(*program.getIntermediate(stage), spirv, &logger, &spvOptions);
 
-    if (const std::string messages = logger.getAllMessages(); !messages.empty())
+#ifdef OPTIMIZE_SHADERS
+    if (optimize)
     {
-        LogI << "Spirv compiler messages:\n" << messages;
+        // Size passes: inlining, constant folding, dead code and dead branch elimination, store/load elimination, etc.
+        const size_t unoptimizedSize = spirv.size() * sizeof(uint32_t);
+
+        spvOptions.disableOptimizer = false;
+        spvOptions.optimizeSize = optimizeSize;
+        glslang::SpirvToolsTransform(*program.getIntermediate(stage), spirv, &logger, &spvOptions);
+
+        LogI << "Optimized spirv of " << path.GetFileNameWithExtension() << ": " << unoptimizedSize << " -> "
+            << spirv.size() * sizeof(uint32_t) << " bytes\n";
+    }
+#endif
+
+    if (const std::string compilerMessages = logger.getAllMessages(); !compilerMessages.empty())
+    {
+        LogI << "Spirv compiler messages:\n" << compilerMessages;
     }
 
     return spirv;
 }
+
+std::string ShaderCompiler::GetOptionsKey(const bool optimize)
+{
+    using namespace ShaderCompilerDetails;
+
+    const bool optimized = optimize && IsOptimizerAvailable();
+
+    return "glsl" + std::to_string(glslVersion)
+        + ";client" + std::to_string(static_cast<uint32_t>(clientVersion))
+        + ";spirv" + std::to_string(static_cast<uint32_t>(spirvVersion))
+        + ";messages" + std::to_string(static_cast<uint32_t>(messages))
+        + ";opt" + std::to_string(optimized ? 1 : 0)
+        + ";optSize" + std::to_string(optimized && optimizeSize ? 1 : 0);
+}
\ No newline at end of file
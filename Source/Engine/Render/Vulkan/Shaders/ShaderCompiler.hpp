@@ -6,7 +6,23 @@
 class ShaderCompiler
 {
 public:
-    static std::vector<uint32_t> Compile(std::string_view glslCode, ShaderType shaderType, const FilePath& includeDir);
+    // Includes are resolved relative to the path first and then to the include dir,
+    // optimization is skipped if the optimizer isn't available
+    static std::vector<uint32_t> Compile(const FilePath& path, std::string_view glslCode, ShaderType shaderType,
+        const FilePath& includeDir, bool optimize);
+
+    // Built from the options Compile actually uses, part of the spirv cache key
+    static std::string GetOptionsKey(bool optimize);
+
+    // Spirv optimizer comes with SPIRV-Tools, see OPTIMIZE_SHADERS in CMakeLists.txt
+    static constexpr bool IsOptimizerAvailable()
+    {
+#ifdef OPTIMIZE_SHADERS
+        return true;
+#else
+        return false;
+#endif
+    }
 
     ShaderCompiler();
     ~ShaderCompiler();
@@ -49,7 +49,7 @@ public:
     }
 
 private:
-    void Create(const VkExtent2D& requiredExtentInPixels);
+    void Create(const VkExtent2D& requiredExtentInPixels, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
     void Cleanup();
     
     ImageDescription GetRenderTargetDescription() const;
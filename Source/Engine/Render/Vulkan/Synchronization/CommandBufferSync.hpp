@@ -2,12 +2,14 @@
 
 #include <volk.h>
 
+// Binary semaphores are used for swapchain acquire/present only, completion of the submission itself is tracked
+// by the timeline semaphore which is signaled with a monotonically increasing value on each submit
 class CommandBufferSync
 {
 public:
     CommandBufferSync() = default;
-    CommandBufferSync(std::vector<VkSemaphore> aWaitSemaphores, std::vector<VkPipelineStageFlags> aWaitStages,
-        std::vector<VkSemaphore> aSignalSemaphores, VkFence aFence, VkDevice device);
+    CommandBufferSync(std::vector<VkSemaphore> aWaitSemaphores, std::vector<VkPipelineStageFlags2> aWaitStages,
+        std::vector<VkSemaphore> aSignalSemaphores, VkSemaphore aTimelineSemaphore, VkDevice device);
     ~CommandBufferSync();
 
     CommandBufferSync(const CommandBufferSync&) = delete;
@@ -16,10 +18,21 @@ public:
     CommandBufferSync(CommandBufferSync&& other) noexcept;
     CommandBufferSync& operator=(CommandBufferSync&& other) noexcept;
 
-    const std::tuple<const std::vector<VkSemaphore>&, const std::vector<VkPipelineStageFlags>&,
-        const std::vector<VkSemaphore>&, VkFence> AsTuple() const
+    // Returns value that will be signaled by the next submission
+    uint64_t AdvanceTimeline()
     {
-        return { waitSemaphores, waitStages, signalSemaphores, fence };
+        return ++timelineValue;
+    }
+
+    // Blocks until the last submission is finished
+    void Wait() const;
+
+    bool IsComplete() const;
+
+    const std::tuple<const std::vector<VkSemaphore>&, const std::vector<VkPipelineStageFlags2>&,
+        const std::vector<VkSemaphore>&, VkSemaphore> AsTuple() const
+    {
+        return { waitSemaphores, waitStages, signalSemaphores, timelineSemaphore };
     }
 
     const std::vector<VkSemaphore>& GetWaitSemaphores() const
@@ -27,7 +40,7 @@ public:
         return waitSemaphores;
     }
 
-    const std::vector<VkPipelineStageFlags>& GetWaitStages() const
+    const std::vector<VkPipelineStageFlags2>& GetWaitStages() const
     {
         return waitStages;
     }
@@ -37,16 +50,22 @@ public:
         return signalSemaphores;
     }
 
-    VkFence GetFence() const
+    VkSemaphore GetTimelineSemaphore() const
+    {
+        return timelineSemaphore;
+    }
+
+    uint64_t GetTimelineValue() const
     {
-        return fence;
+        return timelineValue;
     }
 
 private:
     std::vector<VkSemaphore> waitSemaphores;
-    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<VkPipelineStageFlags2> waitStages;
     std::vector<VkSemaphore> signalSemaphores;
-    VkFence fence = VK_NULL_HANDLE;
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t timelineValue = 0;
 
     VkDevice device = VK_NULL_HANDLE;
 };
\ No newline at end of file
@@ -3,12 +3,12 @@
 #include "Engine/Render/Vulkan/VulkanUtils.hpp"
 
 CommandBufferSync::CommandBufferSync(std::vector<VkSemaphore> aWaitSemaphores,
-    std::vector<VkPipelineStageFlags> aWaitStages, std::vector<VkSemaphore> aSignalSemaphores,
-    VkFence aFence, VkDevice aDevice)
+    std::vector<VkPipelineStageFlags2> aWaitStages, std::vector<VkSemaphore> aSignalSemaphores,
+    VkSemaphore aTimelineSemaphore, VkDevice aDevice)
     : waitSemaphores{ std::move(aWaitSemaphores) }
     , waitStages{ std::move(aWaitStages) }
     , signalSemaphores{ std::move(aSignalSemaphores) }
-    , fence{ aFence }
+    , timelineSemaphore{ aTimelineSemaphore }
     , device{ aDevice }
 {}
 
@@ -22,10 +22,10 @@ CommandBufferSync::~CommandBufferSync()
     VulkanUtils::DestroySemaphores(device, waitSemaphores);
     VulkanUtils::DestroySemaphores(device, signalSemaphores);
 
-    if (fence != VK_NULL_HANDLE)
+    if (timelineSemaphore != VK_NULL_HANDLE)
     {
-        vkDestroyFence(device, fence, nullptr);
-        fence = VK_NULL_HANDLE;
+        vkDestroySemaphore(device, timelineSemaphore, nullptr);
+        timelineSemaphore = VK_NULL_HANDLE;
     }
 
     device = VK_NULL_HANDLE;
@@ -35,13 +35,16 @@ CommandBufferSync::CommandBufferSync(CommandBufferSync&& other) noexcept
     : waitSemaphores{ std::move(other.waitSemaphores) }
     , waitStages{ std::move(other.waitStages) }
     , signalSemaphores{ std::move(other.signalSemaphores) }
-    , fence{ other.fence }
+    , timelineSemaphore{ other.timelineSemaphore }
+    , timelineValue{ other.timelineValue }
     , device{ other.device }
 {
     other.waitSemaphores.clear();
     other.waitStages.clear();
     other.signalSemaphores.clear();
-    other.fence = VK_NULL_HANDLE;
+    other.timelineSemaphore = VK_NULL_HANDLE;
+    other.timelineValue = 0;
+    other.device = VK_NULL_HANDLE;
 }
 
 CommandBufferSync& CommandBufferSync::operator=(CommandBufferSync&& other) noexcept
@@ -51,8 +54,19 @@ CommandBufferSync& CommandBufferSync::operator=(CommandBufferSync&& other) noexc
         std::swap(waitSemaphores, other.waitSemaphores);
         std::swap(waitStages, other.waitStages);
         std::swap(signalSemaphores, other.signalSemaphores);
-        std::swap(fence, other.fence);
+        std::swap(timelineSemaphore, other.timelineSemaphore);
+        std::swap(timelineValue, other.timelineValue);
         std::swap(device, other.device);
     }
     return *this;
+}
+
+void CommandBufferSync::Wait() const
+{
+    VulkanUtils::WaitSemaphore(device, timelineSemaphore, timelineValue);
+}
+
+bool CommandBufferSync::IsComplete() const
+{
+    return VulkanUtils::GetSemaphoreValue(device, timelineSemaphore) >= timelineValue;
 }
\ No newline at end of file
@@ -25,6 +25,9 @@ namespace VulkanConfig
 
     inline constexpr uint32_t maxSetsInPool = 1000;
 
+    // Size of the descriptor indexed texture array, see BindlessTextureSet
+    inline constexpr uint32_t maxBindlessTextures = 4096;
+
     inline constexpr auto defaultPoolSizeRatios = std::to_array<std::pair<VkDescriptorType, float>>({
         { VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
         { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f },
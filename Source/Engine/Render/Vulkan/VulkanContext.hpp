@@ -5,9 +5,12 @@
 #include "Engine/Render/Vulkan/Surface.hpp"
 #include "Engine/Render/Vulkan/Device.hpp"
 #include "Engine/Render/Vulkan/Swapchain.hpp"
+#include "Engine/Render/Vulkan/DeletionQueue.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineCache.hpp"
 #include "Engine/Render/Vulkan/Managers/MemoryManager.hpp"
 #include "Engine/Render/Vulkan/Managers/ShaderManager.hpp"
 #include "Engine/Render/Vulkan/Managers/DescriptorSetManager.hpp"
+#include "Utils/ThreadPool.hpp"
 
 namespace ES
 {
@@ -50,6 +53,11 @@ public:
         return *swapchain;
     }
 
+    PipelineCache& GetPipelineCache() const
+    {
+        return *pipelineCache;
+    }
+
     MemoryManager& GetMemoryManager() const
     {
         return *memoryManager;
@@ -65,6 +73,16 @@ public:
         return *descriptorSetsManager;
     }
 
+    DeletionQueue& GetDeletionQueue() const
+    {
+        return *deletionQueue;
+    }
+
+    ThreadPool& GetThreadPool() const
+    {
+        return *threadPool;
+    }
+
 private:
     void OnResize(const ES::WindowResized& event);
     void OnBeforeWindowRecreated(const ES::BeforeWindowRecreated& event);
@@ -72,12 +90,17 @@ private:
 
     EventSystem& eventSystem;
 
+    // Records CommandRecorder secondary command buffers, declared first so workers outlive their targets
+    std::unique_ptr<ThreadPool> threadPool;
+
     std::unique_ptr<Instance> instance;
     std::unique_ptr<Surface> surface;
     std::unique_ptr<Device> device;
     std::unique_ptr<Swapchain> swapchain;
+    std::unique_ptr<PipelineCache> pipelineCache;
 
     std::unique_ptr<MemoryManager> memoryManager;
     std::unique_ptr<ShaderManager> shaderManager;
     std::unique_ptr<DescriptorSetManager> descriptorSetsManager;
+    std::unique_ptr<DeletionQueue> deletionQueue;
 };
@@ -24,7 +24,7 @@ namespace VulkanUtils
     std::vector<VkCommandBuffer> CreateCommandBuffers(VkDevice device, const size_t count, VkCommandPool commandPool);
 
     void SubmitCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, const DeviceCommands& commands,
-        const CommandBufferSync& sync);
+        CommandBufferSync& sync);
 
     VkFence CreateFence(VkDevice device, VkFenceCreateFlags flags);
     std::vector<VkFence> CreateFences(VkDevice device, VkFenceCreateFlags flags, size_t count);
@@ -34,6 +34,10 @@ namespace VulkanUtils
     std::vector<VkSemaphore> CreateSemaphores(VkDevice device, size_t count);
     void DestroySemaphores(VkDevice device, std::vector<VkSemaphore>& semaphores);
 
+    VkSemaphore CreateTimelineSemaphore(VkDevice device, uint64_t initialValue = 0);
+    void WaitSemaphore(VkDevice device, VkSemaphore timelineSemaphore, uint64_t value);
+    uint64_t GetSemaphoreValue(VkDevice device, VkSemaphore timelineSemaphore);
+
     VkFramebuffer CreateFrameBuffer(const RenderPass& renderPass, VkExtent2D extent,
         const std::vector<VkImageView>& attachments, const VulkanContext& vulkanContext);
     void DestroyFramebuffers(std::vector<VkFramebuffer>& framebuffers, const VulkanContext& vulkanContext);
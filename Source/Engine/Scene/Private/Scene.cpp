@@ -10,6 +10,7 @@ namespace SceneDetails
     static constexpr std::string_view imagePath = "~/Assets/texture.png";
 
     static uint64_t totalTriangles = 0;
+    static size_t rawFootprint = 0;
 }
 
 uint64_t Scene::GetTotalTriangles()
@@ -22,20 +23,88 @@ void Scene::SetTotalTriangles(uint64_t triangles)
     SceneDetails::totalTriangles = triangles;
 }
 
+size_t Scene::GetRawFootprint()
+{
+    return SceneDetails::rawFootprint;
+}
+
 Scene::Scene(FilePath aPath, const VulkanContext& aVulkanContext)
     : vulkanContext{ aVulkanContext }
     , path{ std::move(aPath) }
+{
+    LoadRaw();
+
+    if (rawMetadataResident)
+    {
+        InitTexture();
+    }
+}
+
+Scene::~Scene()
+{
+    SceneDetails::rawFootprint = 0;
+}
+
+void Scene::SetRawResidency(const RawSceneResidency residency)
+{
+    rawResidency = residency;
+
+    ReleaseRaw();
+}
+
+RawScene& Scene::AcquireRaw()
+{
+    if (!rawGeometryResident)
+    {
+        LogI << "Reloading released scene data: " << path << "\n";
+        LoadRaw();
+    }
+
+    return rawScene;
+}
+
+void Scene::ReleaseRaw()
+{
+    switch (rawResidency)
+    {
+        case RawSceneResidency::eKeepAll:
+            break;
+        case RawSceneResidency::eKeepMetadata:
+            rawScene.ReleaseGeometry();
+            rawGeometryResident = false;
+            break;
+        case RawSceneResidency::eReload:
+            rawScene = {};
+            rawGeometryResident = false;
+            rawMetadataResident = false;
+            break;
+    }
+
+    UpdateRawFootprint();
+}
+
+void Scene::LoadRaw()
 {
     if (std::optional<RawScene> loadResult = SceneHelpers::LoadGltfScene(path))
     {
         rawScene = std::move(loadResult.value());
 
-        InitTexture();
+        if (vulkanContext.GetDevice().GetProperties().meshShadersSupported)
+        {
+            SceneHelpers::GenerateMeshlets(rawScene);
+        }
+
+        rawGeometryResident = true;
+        rawMetadataResident = true;
     }
+
+    UpdateRawFootprint();
 }
 
-Scene::~Scene()
-{}
+void Scene::UpdateRawFootprint() const
+{
+    SceneDetails::rawFootprint = rawScene.GetGeometrySize() + rawScene.GetMetadataSize();
+}
 
 void Scene::InitTexture()
 {
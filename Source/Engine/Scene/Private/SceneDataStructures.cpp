@@ -1 +1,52 @@
-#include "Engine/Scene/SceneDataStructures.hpp"
\ No newline at end of file
+#include "Engine/Scene/SceneDataStructures.hpp"
+
+namespace SceneDataStructuresDetails
+{
+    template <typename T>
+    static size_t GetAllocatedSize(const std::vector<T>& vector)
+    {
+        return vector.capacity() * sizeof(T);
+    }
+
+    template <typename T>
+    static void Release(std::vector<T>& vector)
+    {
+        std::vector<T>().swap(vector); // clear() keeps the capacity
+    }
+}
+
+size_t RawScene::GetGeometrySize() const
+{
+    using namespace SceneDataStructuresDetails;
+
+    return GetAllocatedSize(vertices) + GetAllocatedSize(indices) + GetAllocatedSize(shortIndices)
+        + GetAllocatedSize(meshletData) + GetAllocatedSize(meshlets);
+}
+
+size_t RawScene::GetMetadataSize() const
+{
+    using namespace SceneDataStructuresDetails;
+
+    return GetAllocatedSize(primitives) + GetAllocatedSize(lods) + GetAllocatedSize(meshes);
+}
+
+std::span<gpu::Lod> RawScene::GetLods(const size_t primitiveIndex)
+{
+    return std::span(lods).subspan(primitiveIndex * gpu::maxLodCount, primitives[primitiveIndex].lodCount);
+}
+
+std::span<const gpu::Lod> RawScene::GetLods(const size_t primitiveIndex) const
+{
+    return std::span(lods).subspan(primitiveIndex * gpu::maxLodCount, primitives[primitiveIndex].lodCount);
+}
+
+void RawScene::ReleaseGeometry()
+{
+    using namespace SceneDataStructuresDetails;
+
+    Release(vertices);
+    Release(indices);
+    Release(shortIndices);
+    Release(meshletData);
+    Release(meshlets);
+}
\ No newline at end of file
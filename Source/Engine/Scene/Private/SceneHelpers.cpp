@@ -123,6 +123,35 @@ namespace SceneHelpersDetails
         return removedVertices;
     }
 
+    // Indices are relative to the primitive vertex offset, so most of the lods fit
+    static bool FitsShortIndices(const std::span<const uint32_t> indices)
+    {
+        return std::ranges::all_of(indices, [](const uint32_t index) {
+            return index <= std::numeric_limits<uint16_t>::max();
+        });
+    }
+
+    static void AddLodIndices(gpu::Lod& lod, const std::span<const uint32_t> indices, RawScene& rawScene)
+    {
+        lod.indexCount = static_cast<uint32_t>(indices.size());
+        lod.bShortIndices = FitsShortIndices(indices) ? 1 : 0;
+
+        if (lod.bShortIndices)
+        {
+            lod.indexOffset = static_cast<uint32_t>(rawScene.shortIndices.size());
+
+            std::ranges::transform(indices, std::back_inserter(rawScene.shortIndices), [](const uint32_t index) {
+                return static_cast<uint16_t>(index);
+            });
+        }
+        else
+        {
+            lod.indexOffset = static_cast<uint32_t>(rawScene.indices.size());
+
+            rawScene.indices.insert(rawScene.indices.end(), indices.begin(), indices.end());
+        }
+    }
+
     static glm::vec3 CalculateCenter(const std::span<const gpu::Vertex> vertices)
     {
         glm::vec3 center = Vector3::zero;
@@ -177,6 +206,9 @@ namespace SceneHelpersDetails
         primitive.vertexCount = vertexCount;
         primitive.lodCount = 0;
 
+        rawScene.lods.resize(rawScene.lods.size() + gpu::maxLodCount);
+        const auto lods = std::span(rawScene.lods).last(gpu::maxLodCount);
+
         // TODO: Load raw attributes to separate arrays and then merge instead of unmerging in cases like this
         std::vector<glm::vec3> positions;
         positions.reserve(vertices.size());
@@ -200,17 +232,15 @@ namespace SceneHelpersDetails
 
         constexpr std::array normalWeights = { 1.0f, 1.0f, 1.0f };
 
-        for (gpu::Lod& lod : primitive.lods)
+        for (gpu::Lod& lod : lods)
         {
+            primitive.lodErrors[primitive.lodCount] = lodError * lodScale;
             ++primitive.lodCount;
 
-            lod.indexOffset = static_cast<uint32_t>(rawScene.indices.size());
-            lod.indexCount = static_cast<uint32_t>(indices.size());
             lod.meshletOffset = 0;
             lod.meshletCount = 0;
-            lod.error = lodError * lodScale;
 
-            rawScene.indices.insert(rawScene.indices.end(), indices.begin(), indices.end());
+            AddLodIndices(lod, indices, rawScene);
 
             if (primitive.lodCount < gpu::maxLodCount)
             {
@@ -434,15 +464,29 @@ void SceneHelpers::GenerateMeshlets(RawScene& rawScene)
 {
     ScopeTimer timer("Generate meshlets");
 
-    for (gpu::Primitive& primitive : rawScene.primitives)
+    // Meshlets are built from 32-bit indices only
+    std::vector<uint32_t> widenedIndices;
+
+    for (size_t primitiveIndex = 0; primitiveIndex < rawScene.primitives.size(); ++primitiveIndex)
     {
+        const gpu::Primitive& primitive = rawScene.primitives[primitiveIndex];
         const auto vertices = std::span(rawScene.vertices.data() + primitive.vertexOffset, primitive.vertexCount);
 
-        for (uint32_t i = 0; i < primitive.lodCount; ++i)
+        for (gpu::Lod& lod : rawScene.GetLods(primitiveIndex))
         {
-            gpu::Lod& lod = primitive.lods[i];
+            std::span<const uint32_t> indices;
 
-            const auto indices = std::span(rawScene.indices.data() + lod.indexOffset, lod.indexCount);
+            if (lod.bShortIndices)
+            {
+                const auto shortIndices = std::span(rawScene.shortIndices).subspan(lod.indexOffset, lod.indexCount);
+                widenedIndices.assign(shortIndices.begin(), shortIndices.end());
+
+                indices = widenedIndices;
+            }
+            else
+            {
+                indices = std::span(rawScene.indices).subspan(lod.indexOffset, lod.indexCount);
+            }
 
             lod.meshletOffset = static_cast<uint32_t>(rawScene.meshlets.size());
             lod.meshletCount = static_cast<uint32_t>(SceneHelpersDetails::GenerateMeshlets(vertices, indices,
@@ -474,10 +518,10 @@ std::vector<gpu::Draw> SceneHelpers::GenerateDraws(const RawScene& rawScene)
             for (uint32_t index : std::ranges::views::iota(mesh.firstPrimitiveIndex, 
                 mesh.firstPrimitiveIndex + mesh.primitiveCount))
             {
-                draws.emplace_back(
+                draws.push_back(gpu::PackDraw(
                     glm::vec3(positionDist(rng), positionDist(rng), positionDist(rng)), 
                     scaleDist(rng),
-                    glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w), index);
+                    glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w), index));
             }
         }
     }
@@ -17,6 +17,9 @@ public:
     static uint64_t GetTotalTriangles();
     static void SetTotalTriangles(uint64_t triangles);
 
+    // Bytes held by CPU copies of the current scene data
+    static size_t GetRawFootprint();
+
     Scene(FilePath path, const VulkanContext& vulkanContext);
     ~Scene();
 
@@ -31,12 +34,30 @@ public:
         return camera;
     }
 
-    RawScene& GetRaw()
+    // Invalid if the scene metadata wasn't loaded
+    const Texture& GetTexture() const
+    {
+        return texture;
+    }
+
+    RawSceneResidency GetRawResidency() const
     {
-        return rawScene;
+        return rawResidency;
     }
 
+    // Releases the data right away if the new residency keeps less. Released data isn't loaded back here,
+    // it comes back with AcquireRaw on the next scene open
+    void SetRawResidency(RawSceneResidency residency);
+
+    // Reloads the released data from the asset, call ReleaseRaw once done with it.
+    // There is no baked scene cache, so reloading parses the glTF and builds meshlets again: scene open only
+    RawScene& AcquireRaw();
+    void ReleaseRaw();
+
 private:
+    void LoadRaw();
+    void UpdateRawFootprint() const;
+
     void InitTexture();
 
     const VulkanContext& vulkanContext;
@@ -48,4 +69,7 @@ private:
     FilePath path;
 
     RawScene rawScene;
+    RawSceneResidency rawResidency = RawSceneResidency::eKeepAll;
+    bool rawGeometryResident = false;
+    bool rawMetadataResident = false;
 };
@@ -14,14 +14,34 @@ struct Mesh
     glm::mat4 transform;
 };
 
+// What's left of the scene CPU data once its geometry is uploaded, see Scene::ReleaseRaw
+enum class RawSceneResidency
+{
+    eKeepAll = 0,
+    eKeepMetadata, // Primitives (bounds and lods) and meshes only, geometry is reloaded from the asset if needed
+    eReload, // Everything is reloaded from the asset if needed
+};
+
 struct RawScene
 {
+    // Allocated sizes, these are what the process actually holds
+    size_t GetGeometrySize() const;
+    size_t GetMetadataSize() const;
+
+    void ReleaseGeometry();
+
+    // Valid lods of the primitive, gpu::maxLodCount slots are reserved for each one in lods
+    std::span<gpu::Lod> GetLods(size_t primitiveIndex);
+    std::span<const gpu::Lod> GetLods(size_t primitiveIndex) const;
+
     // GPU data
     std::vector<gpu::Vertex> vertices;
     std::vector<uint32_t> indices;
+    std::vector<uint16_t> shortIndices; // Lods with gpu::Lod::bShortIndices
     std::vector<uint32_t> meshletData;
     std::vector<gpu::Meshlet> meshlets;
     std::vector<gpu::Primitive> primitives;
+    std::vector<gpu::Lod> lods;
 
     // CPU data
     std::vector<Mesh> meshes;
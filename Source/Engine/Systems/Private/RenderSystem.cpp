@@ -1,6 +1,7 @@
 #include "Engine/Systems/RenderSystem.hpp"
 
 #include "Engine/EventSystem.hpp"
+#include "Engine/FileSystem/FileWatcher.hpp"
 #include "Engine/Render/SceneRenderer.hpp"
 #include "Engine/Render/Ui/UiRenderer.hpp"
 #include "Engine/Render/ComputeRenderer.hpp"
@@ -9,6 +10,9 @@
 
 namespace RenderSystemDetails
 {
+    static constexpr std::string_view shadersDir = "~/Shaders";
+    static constexpr std::string_view compiledShadersDir = "~/Shaders/Compiled";
+
     static CommandBufferSync CreateFrameSync(const VulkanContext& vulkanContext)
     {
         using namespace VulkanUtils;
@@ -16,11 +20,11 @@ namespace RenderSystemDetails
         const VkDevice device = vulkanContext.GetDevice();
         
         std::vector<VkSemaphore> waitSemaphores = { CreateSemaphore(device) };
-        std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+        std::vector<VkPipelineStageFlags2> waitStages = { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT };
         std::vector<VkSemaphore> signalSemaphores = { CreateSemaphore(device) };
-        VkFence fence = CreateFence(device, VK_FENCE_CREATE_SIGNALED_BIT);
+        VkSemaphore timelineSemaphore = CreateTimelineSemaphore(device);
         
-        return { waitSemaphores, waitStages, signalSemaphores, fence, device };
+        return { waitSemaphores, waitStages, signalSemaphores, timelineSemaphore, device };
     }
 
     static VkCommandBuffer CreateCommandBuffer(const VulkanContext& vulkanContext)
@@ -31,6 +35,13 @@ namespace RenderSystemDetails
         return VulkanUtils::CreateCommandBuffers(device, 1, longLivedPool)[0];
     }
 
+    static std::unique_ptr<CommandRecorder> CreateCommandRecorder(const VulkanContext& vulkanContext)
+    {
+        // Stats query is active while the scene is rendered so secondary buffers have to inherit it
+        return std::make_unique<CommandRecorder>(VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT, false,
+            vulkanContext);
+    }
+
     static VkQueryPool CreateQueryPool(const VulkanContext& vulkanContext)
     {
         VkQueryPoolCreateInfo queryPoolInfo = { .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
@@ -64,11 +75,16 @@ RenderSystem::RenderSystem(const Window& window, EventSystem& aEventSystem, cons
     , sceneRenderer{ std::make_unique<SceneRenderer>(eventSystem, aVulkanContext) }
     , computeRenderer{ std::make_unique<ComputeRenderer>(eventSystem, aVulkanContext) }
     , uiRenderer{ std::make_unique<UiRenderer>(window, eventSystem, aVulkanContext) }
+    , shaderWatcher{ std::make_unique<FileWatcher>(FilePath(RenderSystemDetails::shadersDir),
+        std::vector{ FilePath(RenderSystemDetails::compiledShadersDir) }) }
 {
     using namespace RenderSystemDetails;
     
+    timestampQueryPool = GpuTimers::CreateQueryPool(*vulkanContext);
+
     const auto createFrame = [&](const uint32_t index) {
-        return Frame(index, 0, CreateCommandBuffer(*vulkanContext), CreateFrameSync(*vulkanContext));
+        return Frame(index, 0, CreateCommandBuffer(*vulkanContext), CreateFrameSync(*vulkanContext),
+            CreateCommandRecorder(*vulkanContext), timestampQueryPool);
     };
     
     constexpr auto frameIndices = std::views::iota(static_cast<uint32_t>(0), VulkanConfig::maxFramesInFlight);
@@ -90,6 +106,7 @@ RenderSystem::~RenderSystem()
     vulkanContext->GetDescriptorSetsManager().ResetDescriptors(DescriptorScope::eGlobal);
 
     vkDestroyQueryPool(vulkanContext->GetDevice(), queryPool, nullptr);
+    vkDestroyQueryPool(vulkanContext->GetDevice(), timestampQueryPool, nullptr);
 }
 
 void RenderSystem::Process(const float deltaSeconds)
@@ -99,6 +116,24 @@ void RenderSystem::Process(const float deltaSeconds)
         SetRenderer(renderOptions->GetRendererType());
     }
     
+    // Only shaders depending on the changed files get rebuilt, Ctrl+R still reloads everything.
+    // Changed files are unknown after the watcher overflow, so everything is reloaded as well
+    if (FileWatcher::Changes changes = shaderWatcher->PollChanges(); changes.overflow)
+    {
+        ReloadShaders({});
+    }
+    else if (!changes.files.empty())
+    {
+        ReloadShaders(std::move(changes.files));
+    }
+
+    if (const ShaderManager& shaderManager = vulkanContext->GetShaderManager();
+        renderOptions->GetOptimizeShaders() != shaderManager.IsOptimizationEnabled())
+    {
+        shaderManager.SetOptimizationEnabled(renderOptions->GetOptimizeShaders());
+        ReloadShaders({});
+    }
+    
     renderer->Process(frames[currentFrame], deltaSeconds);
     uiRenderer->Process(frames[currentFrame], deltaSeconds);
 }
@@ -109,31 +144,59 @@ void RenderSystem::Render()
 
     Frame& frame = frames[currentFrame];
 
-    const auto& [waitSemaphores, waitStages, signalSemaphores, fence] = frame.sync.AsTuple();
+    const auto& [waitSemaphores, waitStages, signalSemaphores, timelineSemaphore] = frame.sync.AsTuple();
 
     const Device& device = vulkanContext->GetDevice();
 
-    // Wait for frame to finish execution and signal fence
-    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
-    vkResetFences(device, 1, &fence);
+    // Wait until the previous submission of this frame reaches its timeline value, after that all of the frame
+    // resources (command buffer, query, per frame buffers) can be reused
+    frame.sync.Wait();
+
+    frame.recorder->Reset();
+
+    vulkanContext->GetMemoryManager().SetCurrentFrame(frameNumber);
 
-    // Gather gpu frame data
-    vkGetQueryPoolResults(device, queryPool, currentFrame, 1, sizeof(frame.stats), &frame.stats, sizeof(frame.stats),
-        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    // Before the flush, so buffers enqueued for deletion are never destroyed in the middle of their move.
+    // Moves are recorded first, the rest of the frame already sees buffers at their new place
+    if (vulkanContext->GetMemoryManager().Defragment(frame.index, *frame.recorder))
+    {
+        eventSystem.Fire<ES::BuffersRelocated>();
+    }
+
+    vulkanContext->GetDeletionQueue().Flush(frame.index);
+    vulkanContext->GetDescriptorSetsManager().BeginFrame(frame.index);
+
+    // Gather gpu frame data, results are guaranteed to be available at this point so no need to wait on the query
+    const VkResult queryResult = vkGetQueryPoolResults(device, queryPool, currentFrame, 1, sizeof(frame.stats),
+        &frame.stats, sizeof(frame.stats), VK_QUERY_RESULT_64_BIT);
+    Assert(queryResult == VK_SUCCESS);
+
+    GpuTimers::GetResults(*vulkanContext, timestampQueryPool, frame.index, frame.stats.gpuTimesMs);
 
     // Acquire next image from the swapchain, frame wait semaphore will be signaled by the presentation engine when it
     // finishes using the image so we can start rendering
     frame.swapchainImageIndex = AcquireNextSwapchainImage(waitSemaphores[0]);
 
-    // Submit scene rendering commands
-    const auto renderCommands = [&](VkCommandBuffer commandBuffer) {
-        vkCmdResetQueryPool(commandBuffer, queryPool, currentFrame, 1);
+    // Renderers only collect their commands here, the heavy ones are recorded into secondary command buffers
+    // on worker threads while the rest of the frame is being collected
+    frame.recorder->Record([&](VkCommandBuffer commandBuffer) {
+        GpuTimers::Reset(commandBuffer, timestampQueryPool, frame.index);
 
-        vkCmdBeginQuery(commandBuffer, queryPool, currentFrame, 0);      
-        renderer->Render(frame);
-        vkCmdEndQuery(commandBuffer, queryPool, currentFrame);
-        
-        uiRenderer->Render(frame);
+        vkCmdResetQueryPool(commandBuffer, queryPool, frame.index, 1);
+        vkCmdBeginQuery(commandBuffer, queryPool, frame.index, 0);
+    });
+
+    renderer->Render(frame);
+
+    frame.recorder->Record([&](VkCommandBuffer commandBuffer) {
+        vkCmdEndQuery(commandBuffer, queryPool, frame.index);
+    });
+
+    uiRenderer->Render(frame);
+
+    // Submit rendering commands, primary command buffer just executes everything collected above in order
+    const auto renderCommands = [&](VkCommandBuffer commandBuffer) {
+        frame.recorder->Flush(commandBuffer);
     };
 
     SubmitCommandBuffer(frame.commandBuffer, device.GetQueues().graphicsAndCompute, renderCommands, frame.sync);
@@ -142,6 +205,7 @@ void RenderSystem::Render()
     Present(signalSemaphores, frame.swapchainImageIndex);
 
     currentFrame = (currentFrame + 1) % VulkanConfig::maxFramesInFlight;
+    ++frameNumber;
 }
 
 uint32_t RenderSystem::AcquireNextSwapchainImage(const VkSemaphore signalSemaphore) const
@@ -176,11 +240,17 @@ void RenderSystem::SetRenderer(RendererType aRendererType)
     renderer = rendererType == RendererType::eScene ? sceneRenderer.get() : computeRenderer.get();
 }
 
+void RenderSystem::ReloadShaders(std::vector<std::string> changedFiles)
+{
+    vulkanContext->GetShaderManager().EnableSourceCompilation();
+    eventSystem.Fire(ES::TryReloadShaders{ std::move(changedFiles) });
+}
+
 void RenderSystem::OnKeyInput(const ES::KeyInput& event)
 {
     if (event.key == Key::eR && event.action == KeyAction::ePress &&
         HasMod(event.mods, ctrlKeyMod))
     {
-        eventSystem.Fire<ES::TryReloadShaders>();
+        ReloadShaders({});
     }
 }
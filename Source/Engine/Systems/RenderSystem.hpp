@@ -15,6 +15,7 @@ class VulkanContext;
 class Window;
 class EventSystem;
 class Renderer;
+class FileWatcher;
 
 class RenderSystem : public System
 {
@@ -38,6 +39,9 @@ private:
     
     void SetRenderer(RendererType rendererType);
 
+    // Empty list reloads everything
+    void ReloadShaders(std::vector<std::string> changedFiles);
+
     void OnKeyInput(const ES::KeyInput& event);
 
     const VulkanContext* vulkanContext = nullptr;
@@ -48,12 +52,16 @@ private:
     std::unique_ptr<Renderer> sceneRenderer;
     std::unique_ptr<Renderer> computeRenderer;
     std::unique_ptr<Renderer> uiRenderer;
+
+    std::unique_ptr<FileWatcher> shaderWatcher;
     
     std::vector<Frame> frames;
     uint32_t currentFrame = 0;
+    uint32_t frameNumber = 0; // Total frames rendered, unlike currentFrame it never wraps
     
     RendererType rendererType;
     Renderer* renderer = nullptr;
 
     VkQueryPool queryPool = VK_NULL_HANDLE;
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
 };
@@ -18,33 +18,12 @@ namespace gpu
 #else
 #extension GL_EXT_shader_8bit_storage: require
 #extension GL_EXT_shader_16bit_storage: require
+#extension GL_EXT_buffer_reference: require
 #extension GL_GOOGLE_include_directive: require
 
 #include "Config.h"
 #endif
 
-struct CullData
-{
-    mat4 view;
-    // Frustum planes' components in view space
-    float frustumRightX;
-    float frustumRightZ;
-    float frustumTopY;
-    float frustumTopZ;
-    float near;
-};
-
-struct PushConstants 
-{
-    mat4 view;
-    mat4 projection;
-    uint drawCount;
-    uint bMeshPipeline;
-    uint bUseLod;
-    float lodTarget; // lod target error at z = 1
-    CullData cullData;
-};
-
 // TODO: Use positions only for shadows pass: measure impact and try to separate, do the packing, now 64 bytes / vertex
 struct Vertex
 {
@@ -71,15 +50,18 @@ struct Meshlet
     uint padding2;
 };
 
+// Read only for the draws that survive culling. Each primitive has MAX_LOD_COUNT of them in the lod buffer
+// starting at primitiveIndex * MAX_LOD_COUNT, only the first lodCount are valid
 struct Lod
 {
     uint indexOffset;
     uint indexCount;
     uint meshletOffset;
     uint meshletCount;
-    float error;
+    uint bShortIndices; // Indices are uint16_t and live in the 16-bit index buffer, indexOffset is in there too
 };
 
+// Everything culling and lod selection need, it's read for every draw so lods themselves are kept out of it
 struct Primitive
 {
     // TODO: Calculate for culling
@@ -90,23 +72,36 @@ struct Primitive
     uint vertexCount;
 
     uint lodCount;
-    Lod lods[MAX_LOD_COUNT];
-    uint padding;
+    uint finestResidentLod; // Lods from this one to the coarsest are resident, finer ones are streamed in on request
+    float lodErrors[MAX_LOD_COUNT];
 };
 
-struct Draw // Per individual thread in PrimitiveCull workgroup, the "highest level" draw
+// Per individual thread in PrimitiveCull workgroup, the "highest level" draw. It's read by culling and then again
+// by the vertex or mesh shader for every draw, so it's quantized: create with PackDraw, read with unpackDraw* helpers
+// from Math.glsl
+struct Draw
 {
-    vec3 position;
-    float scale;
-    vec4 rotation;
-
+    vec2 positionXY; // vec3 would align the struct to 16 bytes and pad it to 32
+    float positionZ;
     uint primitiveIndex;
-    // material index, etc.
-    uint padding1;
-    uint padding2;
-    uint padding3; // TODO: Fix paddings
+    // Rotation quaternion xyz as snorm16 (w >= 0 is reconstructed) and half float scale in the last 16 bits
+    uvec2 rotationAndScale;
 };
 
+#ifdef __cplusplus
+inline Draw PackDraw(const vec3 position, const float scale, const vec4 rotation, const uint primitiveIndex)
+{
+    // q and -q are the same rotation, so w sign is fixed and w itself is not stored
+    const vec4 q = rotation.w < 0.0f ? -rotation : rotation;
+
+    const uint packedZ = packSnorm2x16(vec2(q.z, 0.0f)) & 0xFFFF;
+    const uint packedScale = packHalf2x16(vec2(scale, 0.0f)) << 16;
+
+    return { .positionXY = vec2(position), .positionZ = position.z, .primitiveIndex = primitiveIndex,
+        .rotationAndScale = uvec2(packSnorm2x16(vec2(q.x, q.y)), packedZ | packedScale) };
+}
+#endif
+
 struct IndirectCommand
 {
     uint drawIndex;
@@ -133,6 +128,86 @@ struct TaskPayload
     uint meshletOffset;
 };
 
+// Scene buffers are accessed through buffer device addresses from the frame data, so passes need no descriptors.
+// Cpp side just sees 64-bit addresses, glsl side sees references to runtime arrays (access as buffer.data[i])
+#ifdef __cplusplus
+#define BUFFER_REFERENCE(Name, Type) using Name = uint64_t;
+#else
+#define BUFFER_REFERENCE(Name, Type) layout(buffer_reference, std430) buffer Name { Type data[]; };
+#endif
+
+BUFFER_REFERENCE(VertexBuffer, Vertex)
+BUFFER_REFERENCE(MeshletDataBuffer8, uint8_t)
+BUFFER_REFERENCE(MeshletDataBuffer16, uint16_t)
+BUFFER_REFERENCE(MeshletDataBuffer32, uint)
+BUFFER_REFERENCE(MeshletBuffer, Meshlet)
+BUFFER_REFERENCE(PrimitiveBuffer, Primitive)
+BUFFER_REFERENCE(LodBuffer, Lod)
+BUFFER_REFERENCE(LodRequestBuffer, uint)
+BUFFER_REFERENCE(DrawBuffer, Draw)
+BUFFER_REFERENCE(CountBuffer, uint)
+BUFFER_REFERENCE(IndirectCommandBuffer, IndirectCommand)
+BUFFER_REFERENCE(TaskCommandBuffer, TaskCommand)
+BUFFER_REFERENCE(SortKeyBuffer, uint)
+
+#undef BUFFER_REFERENCE
+
+struct CullData
+{
+    mat4 view;
+    // Frustum planes' components in view space
+    float frustumRightX;
+    float frustumRightZ;
+    float frustumTopY;
+    float frustumTopZ;
+    float near;
+    // Keeps the cpp size equal to the std430 one, scene buffers follow it in FrameData
+    float padding1;
+    float padding2;
+    float padding3;
+};
+
+// Lives in a per frame buffer (set 1) instead of push constants so recorded commands can be reused between frames
+struct FrameData
+{
+    mat4 view;
+    mat4 projection;
+    uint drawCount;
+    float lodTarget; // lod target error at z = 1
+    uint shortCommandsOffset; // Vertex pipeline only, commands of the lods with bShortIndices start here
+    uint sortDepthBits; // Low bits of the sort key, the high ones hold any primitive slot, see PrimitiveCull.comp
+    CullData cullData;
+
+    VertexBuffer vertices;
+    MeshletDataBuffer32 meshletData; // Reinterpret with MeshletDataBuffer8/16 for smaller elements
+    MeshletBuffer meshlets;
+    PrimitiveBuffer primitives;
+    LodBuffer lods;
+    DrawBuffer draws;
+    CountBuffer commandCount;
+    IndirectCommandBuffer commands; // Either indirect or task commands, reinterpret with TaskCommandBuffer
+    IndirectCommandBuffer culledCommands; // Same as commands or unsorted commands if draws are sorted
+    SortKeyBuffer sortKeys;
+    LodRequestBuffer lodRequests; // Finest lod wanted by the visible draws of each primitive slot, see LodStreamer
+};
+
+struct RadixSortPushConstants
+{
+    uint shift;
+    uint bFirstPass;
+    uint bMeshPipeline;
+    // Batch of the commands to sort, it's sorted in place within its range of all buffers
+    uint countIndex;
+    uint elementOffset;
+    uint maxElementCount;
+};
+
+// 16-bit index batch is drawn by a separate indirect call and gl_DrawIDARB restarts from 0 in it
+struct ForwardPushConstants
+{
+    uint commandOffset;
+};
+
 #ifdef __cplusplus
 }
 #endif
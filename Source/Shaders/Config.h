@@ -4,20 +4,37 @@
 #define PRIMITIVE_CULL_WG_SIZE 64
 #define PRIMITIVE_CULL_MAX_COMMANDS 4194304 // Based on maxTaskWorkGroupTotalCount for my 3060
 
+// Command count buffer is [count, 1, 1, short count], the first 3 are VkDrawMeshTasksIndirectCommandEXT.
+// Short count is the count of the 16-bit index batch, see FrameData::shortCommandsOffset
+#define COMMAND_COUNT_INDEX 0
+#define SHORT_COMMAND_COUNT_INDEX 3
+
+// 4 bit digits, each workgroup sorts a block of WG_SIZE * ELEMENTS_PER_THREAD keys
+#define RADIX_SORT_WG_SIZE 256
+#define RADIX_SORT_ELEMENTS_PER_THREAD 16
+#define RADIX_SORT_BLOCK_SIZE (RADIX_SORT_WG_SIZE * RADIX_SORT_ELEMENTS_PER_THREAD)
+#define RADIX_SORT_DIGIT_BITS 4
+#define RADIX_SORT_BIN_COUNT 16
+#define RADIX_SORT_MAX_BLOCKS ((PRIMITIVE_CULL_MAX_COMMANDS + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE)
+
 #define TASK_WG_SIZE 64
 #define MESH_WG_SIZE 64
 
 #define MAX_LOD_COUNT 8
+#define LOD_NOT_REQUESTED 0xFFFFFFFF // Lod request buffer value of primitives none of the draws of which are visible
 
 #define MAX_MESHLET_VERTICES 64
 #define MAX_MESHLET_TRIANGLES 96
 
 #define CONTRIBUTION_CULL_THRESHOLD 0.003
 
-#define VISUALIZE_MESHLETS 0
-#define VISUALIZE_LODS 0
-
-#define DEBUG_VERTEX_COLOR VISUALIZE_MESHLETS || VISUALIZE_LODS
+// Specialization constant ids, features are selected per pipeline permutation instead of macros or runtime branches
+#define SPEC_MESH_PIPELINE 0
+#define SPEC_USE_LOD 1
+#define SPEC_VISUALIZE_MESHLETS 2
+#define SPEC_VISUALIZE_LODS 3
+#define SPEC_PRIMITIVE_CULL_WG_SIZE 4
+#define SPEC_STREAM_LODS 5
 
 #ifdef __cplusplus
 #pragma once
@@ -27,13 +44,30 @@ namespace gpu
     constexpr uint32_t primitiveCullWgSize = PRIMITIVE_CULL_WG_SIZE;
     constexpr uint32_t primitiveCullMaxCommands = PRIMITIVE_CULL_MAX_COMMANDS;
 
+    constexpr uint32_t commandCountIndex = COMMAND_COUNT_INDEX;
+    constexpr uint32_t shortCommandCountIndex = SHORT_COMMAND_COUNT_INDEX;
+
+    constexpr uint32_t radixSortWgSize = RADIX_SORT_WG_SIZE;
+    constexpr uint32_t radixSortBlockSize = RADIX_SORT_BLOCK_SIZE;
+    constexpr uint32_t radixSortDigitBits = RADIX_SORT_DIGIT_BITS;
+    constexpr uint32_t radixSortBinCount = RADIX_SORT_BIN_COUNT;
+    constexpr uint32_t radixSortMaxBlocks = RADIX_SORT_MAX_BLOCKS;
+
     constexpr uint32_t taskWgSize = TASK_WG_SIZE;
     constexpr uint32_t meshWgSize = MESH_WG_SIZE;
 
     constexpr uint32_t maxLodCount = MAX_LOD_COUNT;
+    constexpr uint32_t lodNotRequested = LOD_NOT_REQUESTED;
 
     constexpr uint32_t maxMeshletVertices = MAX_MESHLET_VERTICES;
     constexpr uint32_t maxMeshletTriangles = MAX_MESHLET_TRIANGLES;
+
+    constexpr uint32_t specMeshPipeline = SPEC_MESH_PIPELINE;
+    constexpr uint32_t specUseLod = SPEC_USE_LOD;
+    constexpr uint32_t specVisualizeMeshlets = SPEC_VISUALIZE_MESHLETS;
+    constexpr uint32_t specVisualizeLods = SPEC_VISUALIZE_LODS;
+    constexpr uint32_t specPrimitiveCullWgSize = SPEC_PRIMITIVE_CULL_WG_SIZE;
+    constexpr uint32_t specStreamLods = SPEC_STREAM_LODS;
 }
 #endif
 
@@ -1,16 +1,20 @@
 #version 450
 
 #extension GL_GOOGLE_include_directive: require
+#extension GL_EXT_nonuniform_qualifier: require
 
 #include "Config.h"
 
+layout(constant_id = SPEC_VISUALIZE_MESHLETS) const bool bVisualizeMeshlets = false;
+layout(constant_id = SPEC_VISUALIZE_LODS) const bool bVisualizeLods = false;
+
 layout(location = 0) in vec3 inNormal;
 layout(location = 1) in vec4 inTangent;
 layout(location = 2) in vec2 inUv;
 layout(location = 3) in vec4 inColor;
 
-// layout(set = 0, binding = 6) uniform texture2D texImage;
-// layout(set = 0, binding = 7) uniform sampler texSampler;
+// Bindless scene textures, see BindlessTextureSet. Index with nonuniformEXT(textureIndex)
+layout(set = 0, binding = 0) uniform sampler2D textures[];
 
 layout(location = 0) out vec4 outColor;
 
@@ -25,9 +29,5 @@ void main()
     vec3 diffuse = baseColor.rgb * intensity;
     vec3 ambient = baseColor.rgb * 0.2;
 
-    #if DEBUG_VERTEX_COLOR
-        outColor = inColor;
-    #else
-        outColor = vec4(diffuse + ambient, baseColor.a);
-    #endif
+    outColor = bVisualizeMeshlets || bVisualizeLods ? inColor : vec4(diffuse + ambient, baseColor.a);
 }
\ No newline at end of file
@@ -6,24 +6,21 @@
 #include "Common.h"
 #include "Math.glsl"
 
+layout(constant_id = SPEC_VISUALIZE_LODS) const bool bVisualizeLods = false;
+
 layout(location = 0) in vec4 inPosAndU;
 layout(location = 1) in vec4 inNormalAndV;
 layout(location = 2) in vec4 inTangent;
 layout(location = 3) in vec4 inColor;
 
-layout(push_constant) uniform Globals
+layout(set = 1, binding = 0) readonly buffer FrameDataBuffer
 {
-    PushConstants globals;
+    FrameData globals;
 };
 
-layout(set = 0, binding = 0) readonly buffer Draws 
+layout(push_constant) uniform PushConstants
 {
-    Draw draws[]; 
-};
-
-layout(set = 0, binding = 1) readonly buffer IndirectCommands
-{
-    IndirectCommand indirectCommands[];
+    ForwardPushConstants pushConstants;
 };
 
 layout(location = 0) out vec3 outNormal;
@@ -38,16 +35,15 @@ void main()
     vec4 tangent = inTangent;
     vec2 uv = vec2(inPosAndU.w, inNormalAndV.w);
 
-    #if VISUALIZE_LODS
-        vec4 color = hashToColor(hash(gl_InstanceIndex));
-    #else
-        vec4 color = inColor;
-    #endif
+    vec4 color = bVisualizeLods ? hashToColor(hash(gl_InstanceIndex)) : inColor;
+
+    uint commandIndex = pushConstants.commandOffset + gl_DrawIDARB;
+    Draw draw = globals.draws.data[globals.commands.data[commandIndex].drawIndex];
 
-    Draw draw = draws[indirectCommands[gl_DrawIDARB].drawIndex];
+    vec4 rotation = unpackDrawRotation(draw);
 
-    position = rotateQuat(position, draw.rotation) * draw.scale + draw.position;
-    normal = rotateQuat(normal, draw.rotation);    
+    position = rotateQuat(position, rotation) * unpackDrawScale(draw) + unpackDrawPosition(draw);
+    normal = rotateQuat(normal, rotation);    
 
     vec4 clip = globals.projection * globals.view * vec4(position, 1.0);
 
@@ -24,6 +24,24 @@ vec3 rotateQuat(vec3 v, vec4 q)
 	return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
 }
 
+// Draw is quantized, see PackDraw in Common.h
+vec3 unpackDrawPosition(Draw draw)
+{
+    return vec3(draw.positionXY, draw.positionZ);
+}
+
+vec4 unpackDrawRotation(Draw draw)
+{
+    vec3 xyz = vec3(unpackSnorm2x16(draw.rotationAndScale.x), unpackSnorm2x16(draw.rotationAndScale.y).x);
+
+    return vec4(xyz, sqrt(max(1.0 - dot(xyz, xyz), 0.0)));
+}
+
+float unpackDrawScale(Draw draw)
+{
+    return unpackHalf2x16(draw.rotationAndScale.y >> 16).x;
+}
+
 // Adapted version of https://gist.github.com/JarkkoPFC/1186bc8a861dae3c8339b0cda4e6cdb3
 vec4 sphereNdcExtents(vec3 center, float radius, mat4 projection)
 {
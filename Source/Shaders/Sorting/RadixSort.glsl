@@ -0,0 +1,58 @@
+#ifndef RADIX_SORT_GLSL
+#define RADIX_SORT_GLSL
+
+// LSD radix sort of the culled commands, keys are written by PrimitiveCull.comp, values are command indices
+// Src/dst are swapped between passes with a second descriptor set, see DrawSortStage
+
+layout(push_constant) uniform Globals
+{
+    RadixSortPushConstants globals;
+};
+
+layout(set = 0, binding = 0) readonly buffer CommandCounts
+{
+    uint commandCounts[];
+};
+
+layout(set = 0, binding = 1) readonly buffer SrcKeys
+{
+    uint srcKeys[];
+};
+
+layout(set = 0, binding = 2) readonly buffer SrcValues
+{
+    uint srcValues[];
+};
+
+layout(set = 0, binding = 3) writeonly buffer DstKeys
+{
+    uint dstKeys[];
+};
+
+layout(set = 0, binding = 4) writeonly buffer DstValues
+{
+    uint dstValues[];
+};
+
+// Bin major layout: [bin * blockCount + block], so scanned histograms are global scatter offsets right away
+layout(set = 0, binding = 5) buffer Histograms
+{
+    uint histograms[];
+};
+
+uint getElementCount()
+{
+    return min(commandCounts[globals.countIndex], globals.maxElementCount);
+}
+
+uint getBlockCount(uint elementCount)
+{
+    return (elementCount + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE;
+}
+
+uint getDigit(uint key)
+{
+    return (key >> globals.shift) & (RADIX_SORT_BIN_COUNT - 1);
+}
+
+#endif
\ No newline at end of file
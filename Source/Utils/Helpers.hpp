@@ -21,5 +21,8 @@ private:
 
 namespace Helpers
 {
+    inline constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325;
 
+    // FNV-1a, unlike std::hash it's stable between runs and platforms, so it can be used for the data on disk
+    uint64_t Fnv1a(std::span<const std::byte> data, uint64_t hash = fnvOffsetBasis);
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+// TLSF-style allocator of ranges in [0, size), it never touches the memory itself so it's used to sub-allocate gpu
+// buffers. Free blocks are kept in size class bins (log2 classes split linearly) with bitmasks to find a fitting bin
+// in O(1), freed blocks are coalesced with their free neighbours
+class OffsetAllocator
+{
+public:
+    static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+    struct Allocation
+    {
+        uint32_t offset = invalidIndex;
+        uint32_t node = invalidIndex; // Needed to free the allocation
+
+        bool IsValid() const
+        {
+            return node != invalidIndex;
+        }
+    };
+
+    explicit OffsetAllocator(uint32_t size = 0);
+
+    // Returns invalid allocation if there's no free block large enough
+    Allocation Allocate(uint32_t size);
+    void Free(Allocation allocation);
+
+    uint32_t GetSize() const
+    {
+        return size;
+    }
+
+    uint32_t GetFreeSize() const
+    {
+        return freeSize;
+    }
+
+    uint32_t GetLargestFreeBlock() const;
+
+private:
+    static constexpr uint32_t leafBinCount = 8;
+    static constexpr uint32_t topBinCount = 32;
+
+    struct Node
+    {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        bool used = false;
+
+        // Free nodes of the same bin
+        uint32_t binPrev = invalidIndex;
+        uint32_t binNext = invalidIndex;
+
+        // Adjacent blocks in memory, used for coalescing
+        uint32_t neighborPrev = invalidIndex;
+        uint32_t neighborNext = invalidIndex;
+    };
+
+    uint32_t CreateNode(uint32_t offset, uint32_t size);
+    void ReleaseNode(uint32_t node);
+
+    void InsertFree(uint32_t node);
+    void RemoveFree(uint32_t node);
+
+    uint32_t FindFreeBin(uint32_t minBin) const;
+
+    uint32_t size = 0;
+    uint32_t freeSize = 0;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> unusedNodes;
+
+    uint32_t topBinMask = 0;
+    std::array<uint8_t, topBinCount> leafBinMasks = {};
+    std::array<uint32_t, topBinCount * leafBinCount> binHeads = {};
+};
\ No newline at end of file
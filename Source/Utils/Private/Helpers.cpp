@@ -15,5 +15,16 @@ ScopeTimer::~ScopeTimer()
 
 namespace Helpers
 {
+    uint64_t Fnv1a(const std::span<const std::byte> data, uint64_t hash /* = fnvOffsetBasis */)
+    {
+        constexpr uint64_t fnvPrime = 0x100000001b3;
 
+        for (const std::byte byte : data)
+        {
+            hash ^= static_cast<uint64_t>(byte);
+            hash *= fnvPrime;
+        }
+
+        return hash;
+    }
 }
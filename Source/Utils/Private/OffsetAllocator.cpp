@@ -0,0 +1,287 @@
+#include "Utils/OffsetAllocator.hpp"
+
+#include <bit>
+
+namespace OffsetAllocatorDetails
+{
+    // Sizes map to bins like tiny floats: 5 bits of exponent and 3 bits of mantissa, sizes below 8 are exact
+    static constexpr uint32_t mantissaBits = 3;
+    static constexpr uint32_t mantissaValue = 1 << mantissaBits;
+    static constexpr uint32_t mantissaMask = mantissaValue - 1;
+
+    static uint32_t SizeToBinRoundDown(const uint32_t size)
+    {
+        if (size < mantissaValue)
+        {
+            return size;
+        }
+
+        const auto highestBit = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        const uint32_t mantissaShift = highestBit - mantissaBits;
+        const uint32_t exponent = mantissaShift + 1;
+        const uint32_t mantissa = (size >> mantissaShift) & mantissaMask;
+
+        return (exponent << mantissaBits) | mantissa;
+    }
+
+    // Every block in this bin or above is guaranteed to fit the size
+    static uint32_t SizeToBinRoundUp(const uint32_t size)
+    {
+        if (size < mantissaValue)
+        {
+            return size;
+        }
+
+        const auto highestBit = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        const uint32_t mantissaShift = highestBit - mantissaBits;
+        const uint32_t lowBitsMask = (1u << mantissaShift) - 1;
+
+        return SizeToBinRoundDown(size) + ((size & lowBitsMask) != 0 ? 1 : 0);
+    }
+}
+
+OffsetAllocator::OffsetAllocator(const uint32_t aSize /* = 0 */)
+    : size{ aSize }
+    , freeSize{ aSize }
+{
+    binHeads.fill(invalidIndex);
+
+    if (size > 0)
+    {
+        InsertFree(CreateNode(0, size));
+    }
+}
+
+OffsetAllocator::Allocation OffsetAllocator::Allocate(const uint32_t allocationSize)
+{
+    using namespace OffsetAllocatorDetails;
+
+    Assert(allocationSize > 0);
+
+    const uint32_t minBin = SizeToBinRoundUp(allocationSize);
+
+    if (minBin >= binHeads.size())
+    {
+        return {};
+    }
+
+    const uint32_t bin = FindFreeBin(minBin);
+
+    if (bin == invalidIndex)
+    {
+        return {};
+    }
+
+    const uint32_t nodeIndex = binHeads[bin];
+    RemoveFree(nodeIndex);
+
+    const uint32_t remainder = nodes[nodeIndex].size - allocationSize;
+
+    nodes[nodeIndex].size = allocationSize;
+    nodes[nodeIndex].used = true;
+
+    // The rest of the block goes back as a separate free block right after the allocation
+    if (remainder > 0)
+    {
+        const uint32_t remainderIndex = CreateNode(nodes[nodeIndex].offset + allocationSize, remainder);
+
+        Node& remainderNode = nodes[remainderIndex];
+        remainderNode.neighborPrev = nodeIndex;
+        remainderNode.neighborNext = nodes[nodeIndex].neighborNext;
+
+        if (remainderNode.neighborNext != invalidIndex)
+        {
+            nodes[remainderNode.neighborNext].neighborPrev = remainderIndex;
+        }
+
+        nodes[nodeIndex].neighborNext = remainderIndex;
+
+        InsertFree(remainderIndex);
+    }
+
+    freeSize -= allocationSize;
+
+    return { nodes[nodeIndex].offset, nodeIndex };
+}
+
+void OffsetAllocator::Free(const Allocation allocation)
+{
+    Assert(allocation.IsValid() && nodes[allocation.node].used);
+
+    uint32_t nodeIndex = allocation.node;
+
+    nodes[nodeIndex].used = false;
+    freeSize += nodes[nodeIndex].size;
+
+    // Merge with the previous block: it absorbs this one
+    if (const uint32_t prev = nodes[nodeIndex].neighborPrev; prev != invalidIndex && !nodes[prev].used)
+    {
+        RemoveFree(prev);
+
+        nodes[prev].size += nodes[nodeIndex].size;
+        nodes[prev].neighborNext = nodes[nodeIndex].neighborNext;
+
+        if (nodes[prev].neighborNext != invalidIndex)
+        {
+            nodes[nodes[prev].neighborNext].neighborPrev = prev;
+        }
+
+        ReleaseNode(nodeIndex);
+        nodeIndex = prev;
+    }
+
+    // Merge with the next block: this one absorbs it
+    if (const uint32_t next = nodes[nodeIndex].neighborNext; next != invalidIndex && !nodes[next].used)
+    {
+        RemoveFree(next);
+
+        nodes[nodeIndex].size += nodes[next].size;
+        nodes[nodeIndex].neighborNext = nodes[next].neighborNext;
+
+        if (nodes[nodeIndex].neighborNext != invalidIndex)
+        {
+            nodes[nodes[nodeIndex].neighborNext].neighborPrev = nodeIndex;
+        }
+
+        ReleaseNode(next);
+    }
+
+    InsertFree(nodeIndex);
+}
+
+uint32_t OffsetAllocator::GetLargestFreeBlock() const
+{
+    if (topBinMask == 0)
+    {
+        return 0;
+    }
+
+    const auto topBin = static_cast<uint32_t>(std::bit_width(topBinMask)) - 1;
+    const auto leafBin = static_cast<uint32_t>(std::bit_width(static_cast<uint32_t>(leafBinMasks[topBin]))) - 1;
+
+    // Blocks of the same bin differ in size, so check them all
+    uint32_t largest = 0;
+
+    for (uint32_t node = binHeads[topBin * leafBinCount + leafBin]; node != invalidIndex; node = nodes[node].binNext)
+    {
+        largest = std::max(largest, nodes[node].size);
+    }
+
+    return largest;
+}
+
+uint32_t OffsetAllocator::CreateNode(const uint32_t offset, const uint32_t nodeSize)
+{
+    uint32_t nodeIndex;
+
+    if (unusedNodes.empty())
+    {
+        nodeIndex = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    else
+    {
+        nodeIndex = unusedNodes.back();
+        unusedNodes.pop_back();
+    }
+
+    nodes[nodeIndex] = { .offset = offset, .size = nodeSize };
+
+    return nodeIndex;
+}
+
+void OffsetAllocator::ReleaseNode(const uint32_t node)
+{
+    unusedNodes.push_back(node);
+}
+
+void OffsetAllocator::InsertFree(const uint32_t node)
+{
+    using namespace OffsetAllocatorDetails;
+
+    const uint32_t bin = SizeToBinRoundDown(nodes[node].size);
+    const uint32_t topBin = bin / leafBinCount;
+    const uint32_t leafBin = bin % leafBinCount;
+
+    nodes[node].binPrev = invalidIndex;
+    nodes[node].binNext = binHeads[bin];
+
+    if (binHeads[bin] != invalidIndex)
+    {
+        nodes[binHeads[bin]].binPrev = node;
+    }
+
+    binHeads[bin] = node;
+
+    topBinMask |= 1u << topBin;
+    leafBinMasks[topBin] |= static_cast<uint8_t>(1u << leafBin);
+}
+
+void OffsetAllocator::RemoveFree(const uint32_t node)
+{
+    using namespace OffsetAllocatorDetails;
+
+    const Node& freeNode = nodes[node];
+
+    if (freeNode.binPrev != invalidIndex)
+    {
+        nodes[freeNode.binPrev].binNext = freeNode.binNext;
+    }
+
+    if (freeNode.binNext != invalidIndex)
+    {
+        nodes[freeNode.binNext].binPrev = freeNode.binPrev;
+    }
+
+    const uint32_t bin = SizeToBinRoundDown(freeNode.size);
+
+    if (binHeads[bin] != node)
+    {
+        return;
+    }
+
+    binHeads[bin] = freeNode.binNext;
+
+    if (binHeads[bin] == invalidIndex)
+    {
+        const uint32_t topBin = bin / leafBinCount;
+        const uint32_t leafBin = bin % leafBinCount;
+
+        leafBinMasks[topBin] &= static_cast<uint8_t>(~(1u << leafBin));
+
+        if (leafBinMasks[topBin] == 0)
+        {
+            topBinMask &= ~(1u << topBin);
+        }
+    }
+}
+
+uint32_t OffsetAllocator::FindFreeBin(const uint32_t minBin) const
+{
+    const uint32_t minTopBin = minBin / leafBinCount;
+    const uint32_t minLeafBin = minBin % leafBinCount;
+
+    // Look for a fitting leaf bin within the same top bin first
+    if (const uint32_t leafMask = leafBinMasks[minTopBin] & (0xFFu << minLeafBin); leafMask != 0)
+    {
+        return minTopBin * leafBinCount + static_cast<uint32_t>(std::countr_zero(leafMask));
+    }
+
+    if (minTopBin + 1 >= topBinCount)
+    {
+        return invalidIndex;
+    }
+
+    const uint32_t topMask = topBinMask & (~0u << (minTopBin + 1));
+
+    if (topMask == 0)
+    {
+        return invalidIndex;
+    }
+
+    // Any block in a larger top bin fits, take the smallest leaf of the smallest one
+    const auto topBin = static_cast<uint32_t>(std::countr_zero(topMask));
+    const auto leafBin = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(leafBinMasks[topBin])));
+
+    return topBin * leafBinCount + leafBin;
+}
\ No newline at end of file
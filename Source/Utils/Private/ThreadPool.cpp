@@ -0,0 +1,53 @@
+#include "Utils/ThreadPool.hpp"
+
+ThreadPool::ThreadPool(const uint32_t threadCount)
+{
+    Assert(threadCount > 0);
+
+    threads.reserve(threadCount);
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([this](const std::stop_token& stopToken) { Run(stopToken); });
+    }
+}
+
+// Jthreads request stop and join, tasks left in the queue are dropped and their futures get broken_promise
+ThreadPool::~ThreadPool() = default;
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::future<void> future = packagedTask.get_future();
+
+    {
+        std::scoped_lock lock(mutex);
+        tasks.push(std::move(packagedTask));
+    }
+
+    condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::Run(const std::stop_token& stopToken)
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+
+        {
+            std::unique_lock lock(mutex);
+
+            if (!condition.wait(lock, stopToken, [this]() { return !tasks.empty(); }))
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+// Persistent worker threads for short tasks submitted every frame, so no thread is created per task.
+// Tasks must not wait for other tasks of the pool, they'd block the workers those need
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    std::future<void> Submit(std::function<void()> task);
+
+private:
+    void Run(const std::stop_token& stopToken);
+
+    std::mutex mutex;
+    std::condition_variable_any condition;
+    std::queue<std::packaged_task<void()>> tasks;
+
+    std::vector<std::jthread> threads; // Destroyed first, so workers stop before the queue goes away
+};
\ No newline at end of file